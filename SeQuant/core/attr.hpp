@@ -116,6 +116,26 @@ inline std::wstring to_string(Vacuum V) {
   }
 }
 
+/// implementation of the tensor network used to canonicalize tensor products
+/// (see Product::canonicalize())
+enum class TensorNetworkEngine {
+  /// TensorNetwork
+  V1,
+  /// TensorNetworkV2
+  V2
+};
+
+inline std::wstring to_string(TensorNetworkEngine engine) {
+  switch (engine) {
+    case TensorNetworkEngine::V1:
+      return L"TensorNetwork";
+    case TensorNetworkEngine::V2:
+      return L"TensorNetworkV2";
+    default:
+      abort();
+  }
+}
+
 }  // namespace sequant
 
 #endif  // SEQUANT_ATTR_HPP
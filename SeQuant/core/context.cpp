@@ -1,7 +1,10 @@
 #include <SeQuant/core/attr.hpp>
 #include <SeQuant/core/context.hpp>
+#include <SeQuant/core/utility/atomic_shared_ptr.hpp>
 #include <SeQuant/core/utility/context.hpp>
 
+#include <cassert>
+#include <memory>
 #include <mutex>
 
 namespace sequant {
@@ -15,6 +18,7 @@ bool operator==(const Context& ctx1, const Context& ctx2) {
            ctx1.spbasis() == ctx2.spbasis() &&
            ctx1.first_dummy_index_ordinal() ==
                ctx2.first_dummy_index_ordinal() &&
+           ctx1.tensor_network_engine() == ctx2.tensor_network_engine() &&
            *ctx1.index_space_registry() == *ctx2.index_space_registry();
 }
 
@@ -24,21 +28,72 @@ bool operator!=(const Context& ctx1, const Context& ctx2) {
 
 static std::recursive_mutex ctx_mtx;  // used to protect the context
 
+namespace {
+
+using contexts_t = container::map<Statistics, Context>;
+
+/// an immutable snapshot of the default contexts
+struct ContextsSnapshot {
+  /// the value of implicit_context_epoch<contexts_t>() it was taken at
+  std::size_t version;
+  contexts_t contexts;
+};
+
+/// the latest snapshot of the default contexts; the threads reading it hold on
+/// to it, hence a replaced snapshot is destroyed once no thread uses it
+AtomicSharedPtr<const ContextsSnapshot>& published_contexts() {
+  static AtomicSharedPtr<const ContextsSnapshot> snapshot;
+  return snapshot;
+}
+
+/// publishes the snapshot of the current default contexts
+/// @return the published snapshot
+/// @note must be called with ctx_mtx locked
+std::shared_ptr<const ContextsSnapshot> publish_contexts() {
+  const auto& version = detail::implicit_context_epoch<contexts_t>();
+  auto snapshot = std::make_shared<const ContextsSnapshot>(
+      ContextsSnapshot{version.load(std::memory_order_acquire),
+                       detail::get_implicit_context<contexts_t>()});
+  published_contexts().store(snapshot);
+  return snapshot;
+}
+
+}  // namespace
+
 const Context& get_default_context(Statistics s) {
-  std::scoped_lock lock(ctx_mtx);
-  auto& contexts =
-      detail::get_implicit_context<container::map<Statistics, Context>>();
-  auto it = contexts.find(s);
-  /// default for arbitrary statistics is initialized lazily here
-  if (it == contexts.end() && s == Statistics::Arbitrary) {
-    set_default_context({}, Statistics::Arbitrary);
+  // each thread holds on to the latest published snapshot of the default
+  // contexts and only replaces it when the contexts are modified, hence
+  // readers do not lock
+  thread_local std::shared_ptr<const ContextsSnapshot> snapshot;
+
+  const auto& version = detail::implicit_context_epoch<contexts_t>();
+  if (!snapshot ||
+      snapshot->version != version.load(std::memory_order_acquire)) {
+    snapshot = published_contexts().load();
+    // N.B. scoped contexts are reinstated without publishing a snapshot,
+    // and the default for arbitrary statistics is initialized lazily, hence
+    // the snapshot may need to be published here
+    if (!snapshot ||
+        snapshot->version != version.load(std::memory_order_acquire)) {
+      std::scoped_lock lock(ctx_mtx);
+      snapshot = published_contexts().load();
+      if (!snapshot ||
+          snapshot->version != version.load(std::memory_order_acquire)) {
+        const auto& contexts = detail::get_implicit_context<contexts_t>();
+        if (contexts.find(Statistics::Arbitrary) == contexts.end()) {
+          set_default_context({}, Statistics::Arbitrary);
+        }
+        snapshot = publish_contexts();
+      }
+    }
   }
-  it = contexts.find(s);
+
+  const auto& contexts = snapshot->contexts;
+  auto it = contexts.find(s);
   // have context for this statistics? else return for arbitrary statistics
-  if (it != contexts.end())
-    return it->second;
-  else
-    return get_default_context(Statistics::Arbitrary);
+  if (it == contexts.end()) it = contexts.find(Statistics::Arbitrary);
+  assert(it != contexts.end());
+  return it->second;
 }
 
 void set_default_context(const Context& ctx, Statistics s) {
@@ -51,6 +106,8 @@ void set_default_context(const Context& ctx, Statistics s) {
   } else {
     contexts.emplace(s, ctx);
   }
+  ++detail::implicit_context_epoch<container::map<Statistics, Context>>();
+  publish_contexts();
 }
 
 void set_default_context(const container::map<Statistics, Context>& ctxs) {
@@ -62,6 +119,7 @@ void set_default_context(const container::map<Statistics, Context>& ctxs) {
 void reset_default_context() {
   std::scoped_lock lock(ctx_mtx);
   detail::reset_implicit_context<container::map<Statistics, Context>>();
+  publish_contexts();
 }
 
 [[nodiscard]] detail::ImplicitContextResetter<
@@ -128,6 +186,10 @@ std::size_t Context::first_dummy_index_ordinal() const {
   return first_dummy_index_ordinal_;
 }
 
+TensorNetworkEngine Context::tensor_network_engine() const {
+  return tensor_network_engine_;
+}
+
 Context& Context::set(Vacuum vacuum) {
   vacuum_ = vacuum;
   return *this;
@@ -159,6 +221,11 @@ Context& Context::set_first_dummy_index_ordinal(
   return *this;
 }
 
+Context& Context::set(TensorNetworkEngine engine) {
+  tensor_network_engine_ = engine;
+  return *this;
+}
+
 IndexSpace get_particle_space(const IndexSpace::QuantumNumbers& qn) {
   return get_default_context().index_space_registry()->particle_space(qn);
 }
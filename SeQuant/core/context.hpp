@@ -17,6 +17,7 @@ class Context {
     constexpr static auto braket_symmetry = BraKetSymmetry::conjugate;
     constexpr static auto spbasis = sequant::SPBasis::spinorbital;
     constexpr static auto first_dummy_index_ordinal = 100;
+    constexpr static auto tensor_network_engine = TensorNetworkEngine::V2;
   };
 
   /// standard full-form constructor
@@ -91,6 +92,9 @@ class Context {
   /// \return first ordinal of the dummy indices generated by calls to
   /// Index::next_tmp_index when this context is active
   std::size_t first_dummy_index_ordinal() const;
+  /// \return TensorNetworkEngine used to canonicalize tensor products when
+  /// this context is active
+  TensorNetworkEngine tensor_network_engine() const;
 
   /// Sets the Vacuum for this context, convenient for chaining
   /// \param vacuum Vacuum
@@ -116,6 +120,10 @@ class Context {
   /// chaining \param first_dummy_index_ordinal the first dummy index ordinal
   /// \return ref to `*this`, for chaining
   Context& set_first_dummy_index_ordinal(std::size_t first_dummy_index_ordinal);
+  /// Sets the TensorNetworkEngine for this context, convenient for chaining
+  /// \param engine TensorNetworkEngine
+  /// \return ref to `*this`, for chaining
+  Context& set(TensorNetworkEngine engine);
 
  private:
   std::shared_ptr<IndexSpaceRegistry> idx_space_reg_ = nullptr;
@@ -124,6 +132,7 @@ class Context {
   BraKetSymmetry braket_symmetry_ = Defaults::braket_symmetry;
   SPBasis spbasis_ = Defaults::spbasis;
   std::size_t first_dummy_index_ordinal_ = Defaults::first_dummy_index_ordinal;
+  TensorNetworkEngine tensor_network_engine_ = Defaults::tensor_network_engine;
 };
 
 /// Context object equality comparison
@@ -148,6 +157,12 @@ bool operator!=(const Context& ctx1, const Context& ctx2);
 /// @brief access default Context for the given Statistics
 /// @param s Statistics
 /// @return the default context used for Statistics @p s
+/// @note this does not lock: each thread holds on to an immutable snapshot of
+/// the default contexts, which is replaced after they are modified; the
+/// replaced snapshots are destroyed once no thread uses them
+/// @warning the returned reference is valid until the calling thread calls
+/// this again after the default contexts were modified; copy the Context to
+/// keep it for longer
 const Context& get_default_context(Statistics s = Statistics::Arbitrary);
 
 /// @brief sets default Context for the given Statistics
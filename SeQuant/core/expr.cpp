@@ -4,10 +4,13 @@
 
 #include <SeQuant/core/abstract_tensor.hpp>
 #include <SeQuant/core/algorithm.hpp>
+#include <SeQuant/core/context.hpp>
 #include <SeQuant/core/expr.hpp>
 #include <SeQuant/core/logger.hpp>
+#include <SeQuant/core/runtime.hpp>
 #include <SeQuant/core/tensor.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
+#include <SeQuant/core/tensor_network.hpp>
 #include <SeQuant/core/tensor_network_v2.hpp>
 
 #include <range/v3/all.hpp>
@@ -140,7 +143,10 @@ void Constant::adjoint() {
 
 std::wstring_view Variable::label() const { return label_; }
 
-void Variable::conjugate() { conjugated_ = !conjugated_; }
+void Variable::conjugate() {
+  conjugated_ = !conjugated_;
+  reset_hash_value();
+}
 
 bool Variable::conjugated() const { return conjugated_; }
 
@@ -165,7 +171,33 @@ bool Product::is_commutative() const {
   return result;
 }
 
+std::size_t Product::canonical_fingerprint() const {
+  std::size_t seed = factors_.size();
+  for (const auto &factor : factors_) {
+    hash::combine(seed, reinterpret_cast<std::uintptr_t>(factor.get()));
+    hash::combine(seed, factor->hash_value());
+  }
+  hash::combine(
+      seed,
+      detail::implicit_context_epoch<container::map<Statistics, Context>>()
+          .load());
+  hash::combine(seed, TensorCanonicalizer::epoch());
+  return seed;
+}
+
+bool Product::is_canonical(bool rapid) const {
+  const auto state = rapid ? CanonicalState::Rapid : CanonicalState::Full;
+  return (canonical_state_ & state) &&
+         canonical_fingerprint_ == canonical_fingerprint();
+}
+
 ExprPtr Product::canonicalize_impl(bool rapid) {
+  // skip if already canonical
+  if (is_canonical(rapid)) return {};
+  const auto state = rapid ? CanonicalState::Rapid : CanonicalState::Full;
+  const auto state_in = canonical_state_;
+  const auto fingerprint_in = canonical_fingerprint_;
+
   // recursively canonicalize subfactors ...
   ranges::for_each(factors_, [this](auto &factor) {
     auto bp = factor->canonicalize();
@@ -208,20 +240,31 @@ ExprPtr Product::canonicalize_impl(bool rapid) {
   if (!contains_nontensors) {  // tensor network canonization is a special case
                                // that's done in
                                // TensorNetwork
-    TensorNetworkV2 tn(factors_);
-    auto canon_factor =
-        tn.canonicalize(TensorCanonicalizer::cardinal_tensor_labels(), rapid);
-    const auto &tensors = tn.tensors();
-    using std::size;
-    assert(size(tensors) == size(factors_));
-    using std::begin;
-    using std::end;
-    std::transform(begin(tensors), end(tensors), begin(factors_),
-                   [](const auto &tptr) {
-                     auto exprptr = std::dynamic_pointer_cast<Expr>(tptr);
-                     assert(exprptr);
-                     return exprptr;
-                   });
+    auto canonicalize_network = [this, rapid](auto &&tn) {
+      auto canon_factor = tn.canonicalize(
+          TensorCanonicalizer::cardinal_tensor_labels(), rapid);
+      const auto &tensors = tn.tensors();
+      using std::size;
+      assert(size(tensors) == size(factors_));
+      using std::begin;
+      using std::end;
+      std::transform(begin(tensors), end(tensors), begin(factors_),
+                     [](const auto &tptr) {
+                       auto exprptr = std::dynamic_pointer_cast<Expr>(tptr);
+                       assert(exprptr);
+                       return exprptr;
+                     });
+      return canon_factor;
+    };
+    ExprPtr canon_factor;
+    switch (get_default_context().tensor_network_engine()) {
+      case TensorNetworkEngine::V1:
+        canon_factor = canonicalize_network(TensorNetwork(factors_));
+        break;
+      case TensorNetworkEngine::V2:
+        canon_factor = canonicalize_network(TensorNetworkV2(factors_));
+        break;
+    }
     if (canon_factor) scalar_ *= canon_factor->as<Constant>().value();
     this->reset_hash_value();
   } else {  // if contains non-tensors, do commutation-checking resort
@@ -289,6 +332,18 @@ ExprPtr Product::canonicalize_impl(bool rapid) {
     std::wcout << "Product canonicalization(" << (rapid ? "fast" : "slow")
                << ") result: " << to_latex() << std::endl;
 
+  // record the canonical state; the in-place mutations of subexpressions of
+  // composite factors are not tracked, hence only products of atoms qualify
+  if (ranges::all_of(factors_,
+                     [](const auto &factor) { return factor->is_atom(); })) {
+    canonical_fingerprint_ = canonical_fingerprint();
+    // if this was not changed, other canonicalizations are still valid
+    canonical_state_ =
+        (state_in && canonical_fingerprint_ == fingerprint_in)
+            ? (state_in | state)
+            : state;
+  }
+
   return {};  // side effects are absorbed into the scalar_
 }
 
@@ -347,20 +402,24 @@ ExprPtr Sum::canonicalize_impl(bool multipass) {
     std::wcout << "Sum::canonicalize_impl: input = "
                << to_latex_align(shared_from_this()) << std::endl;
 
+  close_front_gap();  // so that summands_ holds only the summands
   const auto npasses = multipass ? 3 : 1;
   for (auto pass = 0; pass != npasses; ++pass) {
     // recursively canonicalize summands ...
-    const auto nsubexpr = ranges::size(*this);
-    for (std::size_t i = 0; i != nsubexpr; ++i) {
-      auto bp = (pass % 2 == 0) ? summands_[i]->rapid_canonicalize()
-                                : summands_[i]->canonicalize();
+    // N.B. summands are independent, hence are canonicalized concurrently
+    auto canonicalize_summand = [pass](ExprPtr &summand) {
+      auto bp = (pass % 2 == 0) ? summand->rapid_canonicalize()
+                                : summand->canonicalize();
       if (bp) {
         assert(bp->template is<Constant>());
-        summands_[i] =
-            ex<Product>(std::static_pointer_cast<Constant>(bp)->value(),
-                        ExprPtrList{summands_[i]});
+        summand = ex<Product>(std::static_pointer_cast<Constant>(bp)->value(),
+                              ExprPtrList{summand});
       }
     };
+    if (ranges::size(*this) > 1 && num_threads() > 1)
+      sequant::for_each(summands_, canonicalize_summand);
+    else
+      ranges::for_each(summands_, canonicalize_summand);
 
     if (Logger::instance().canonicalize)
       std::wcout << "Sum::canonicalize_impl (pass=" << pass
@@ -407,14 +466,15 @@ ExprPtr Sum::canonicalize_impl(bool multipass) {
           for (auto it = begin + 1; it != end; ++it) {
             // convert to Product if not already
             if (!(*it)->template is<Product>()) {
-              *it = std::make_shared<Product>(1, ExprPtrList{*it});
+              *it = ex<Product>(1, ExprPtrList{*it});
             }
             prod.add_identical((*it)->template as<Product>());
           }
           this->summands_.erase(prod.is_zero() ? first_it : first_it + 1, end);
         } else {  // handle all other types
-          auto product_form = std::make_shared<Product>();
-          product_form->append(nidentical, (*first_it)->as<Expr>());
+          auto product_form = ex<Product>();
+          product_form->as<Product>().append(nidentical,
+                                             (*first_it)->as<Expr>());
           *first_it = product_form;
           this->summands_.erase(first_it + 1, end);
         }
@@ -12,6 +12,7 @@
 #include <SeQuant/core/hash.hpp>
 #include <SeQuant/core/latex.hpp>
 #include <SeQuant/core/rational.hpp>
+#include <SeQuant/core/utility/memory_resource.hpp>
 #include <SeQuant/core/wolfram.hpp>
 
 #include <range/v3/all.hpp>
@@ -22,6 +23,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <initializer_list>
@@ -29,6 +31,7 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -691,8 +694,13 @@ inline bool operator!=(const Expr &a, const Expr &b) { return !(a == b); }
 /// @tparam Args a parameter pack type such that T(std::forward<Args>...) is
 /// well-formed
 /// @param args a parameter pack such that T(args...) is well-formed
+/// @note the object is allocated from expr_memory_resource(), if any
+/// @sa ScopedExprMemoryResource
 template <typename T, typename... Args>
 ExprPtr ex(Args &&...args) {
+  if (const auto &resource = expr_memory_resource())
+    return std::allocate_shared<T>(SharedResourceAllocator<T>(resource),
+                                   std::forward<Args>(args)...);
   return std::make_shared<T>(std::forward<Args>(args)...);
 }
 
@@ -1118,6 +1126,14 @@ class Product : public Expr {
   /// @return true if the number of factors is zero
   bool empty() const { return factors_.empty(); }
 
+  /// @param rapid if true, query the result of rapid_canonicalize() rather
+  /// than canonicalize()
+  /// @return true if this is known to be in canonical form, i.e. if it was
+  /// produced by the (rapid) canonicalization and has not been mutated, nor
+  /// have the global canonicalization settings changed, since then
+  /// @note canonicalizing a Product in canonical form is a no-op
+  bool is_canonical(bool rapid = false) const;
+
   /// @brief checks commutativity recursively
   /// @return true if definitely commutative, false definitely not commutative
   /// @note this is memoizing
@@ -1220,6 +1236,17 @@ class Product : public Expr {
   scalar_type scalar_ = {1, 0};
   container::svector<ExprPtr, 2> factors_{};
 
+  /// flags of canonical_state_
+  enum CanonicalState : std::uint8_t { Rapid = 1, Full = 2 };
+  /// bitmask of canonicalizations that are known to leave this unchanged,
+  /// valid as long as canonical_fingerprint() equals canonical_fingerprint_
+  mutable std::uint8_t canonical_state_ = 0;
+  std::size_t canonical_fingerprint_ = 0;
+
+  /// @return the fingerprint of the factors (their addresses and hash values)
+  /// and of the global canonicalization settings
+  std::size_t canonical_fingerprint() const;
+
   cursor begin_cursor() override {
     return factors_.empty() ? Expr::begin_cursor() : cursor{&factors_[0]};
   };
@@ -1248,6 +1275,12 @@ class Product : public Expr {
     return *hash_value_;
   }
 
+  /// mutators reset the hash, hence this also resets the canonical state
+  void reset_hash_value() const override {
+    Expr::reset_hash_value();
+    canonical_state_ = 0;
+  }
+
   ExprPtr canonicalize_impl(bool rapid = false);
   virtual ExprPtr canonicalize() override;
   virtual ExprPtr rapid_canonicalize() override;
@@ -1336,96 +1369,105 @@ class Sum : public Expr {
 
   /// construct a Sum out of a range of summands
   /// @param rng a range
+  /// @sa append_range()
   template <typename Range,
             typename = std::enable_if_t<meta::is_range_v<std::decay_t<Range>> &&
                                         !meta::is_same_v<Range, ExprPtrList>>>
   explicit Sum(Range &&rng) {
-    // use append to flatten out Sum summands
-    for (auto &&v : rng) {
-      append(std::forward<decltype(v)>(v));
-    }
+    // use append_range to flatten out Sum summands
+    append_range(std::forward<Range>(rng));
   }
 
   /// append a summand to the sum
-  /// @param summand the summand
+  /// @param summand the summand; it is cloned, hence @p summand and its
+  /// subexpressions are not shared with this
+  /// @sa adopt()
   Sum &append(ExprPtr summand) {
-    assert(summand);
-    if (!summand->is<Sum>()) {
-      if (summand->is<Constant>()) {  // exclude zeros, add up constants
-                                      // immediately, if possible
-        auto summand_constant = std::static_pointer_cast<Constant>(summand);
-        if (constant_summand_idx_) {
-          assert(summands_.at(*constant_summand_idx_)->is<Constant>());
-          *(summands_[*constant_summand_idx_]) += *summand;
-        } else {
-          if (!summand_constant->is_zero()) {
-            summands_.push_back(summand->clone());
-            constant_summand_idx_ = summands_.size() - 1;
-          }
-        }
-      } else {
-        summands_.push_back(summand->clone());
-      }
-      reset_hash_value();
-    } else {  // this recursively flattens Sum summands
-      for (auto &subsummand : *summand) this->append(subsummand);
+    return append_impl(std::move(summand), /* clone = */ true);
+  }
+
+  /// append a summand to the sum without cloning it
+  /// @param summand the summand; if it is a Sum its summands are moved from
+  /// @pre @p summand and its subexpressions must not be shared with any other
+  /// expression (e.g. it was just built by the caller), since the summands of
+  /// this may be modified in place (e.g. by canonicalize()); use append()
+  /// otherwise
+  Sum &adopt(ExprPtr &&summand) {
+    return append_impl(std::move(summand), /* clone = */ false);
+  }
+
+  /// append a range of summands to the sum
+  /// @param rng a range of summands
+  /// @sa append()
+  template <typename Range,
+            typename = std::enable_if_t<meta::is_range_v<std::decay_t<Range>>>>
+  Sum &append_range(Range &&rng) {
+    if constexpr (ranges::sized_range<Range>)
+      summands_.reserve(summands_.size() + ranges::size(rng));
+    for (auto &&summand : rng) {
+      append(summand);
     }
     return *this;
   }
 
   /// prepend a summand to the sum
-  /// @param summand the summand
+  /// @param summand the summand; it is cloned, as by append()
+  /// @note prepending takes amortized constant time per (non-Sum) summand
   Sum &prepend(ExprPtr summand) {
     assert(summand);
-    if (!summand->is<Sum>()) {
-      if (summand->is<Constant>()) {  // exclude zeros
-        auto summand_constant = std::static_pointer_cast<Constant>(summand);
-        if (constant_summand_idx_) {  // add up to the existing constant ...
-          assert(summands_.at(*constant_summand_idx_)->is<Constant>());
-          *summands_[*constant_summand_idx_] += *summand_constant;
-        } else {  // or include the nonzero constant and update
-                  // constant_summand_idx_
-          if (!summand_constant->is_zero()) {
-            summands_.insert(summands_.begin(), summand->clone());
-            constant_summand_idx_ = 0;
-          }
-        }
-      } else {
-        summands_.insert(summands_.begin(), summand->clone());
-        if (constant_summand_idx_)  // if have a constant, update its position
-          ++*constant_summand_idx_;
+    container::svector<ExprPtr> prefix;  // in the reverse order
+    std::optional<size_t> prefix_constant_idx;
+    collect_prepended(summand, prefix, prefix_constant_idx);
+    if (!prefix.empty()) {
+      // if out of room in front of the summands, make room for as many more
+      // summands as there are (like push_back does at the back)
+      if (prefix.size() > front_gap_) {
+        const auto nslots = prefix.size() - front_gap_ + size();
+        summands_.insert(summands_.begin(), nslots, ExprPtr{});
+        front_gap_ += nslots;
       }
-      reset_hash_value();
-    } else {  // this recursively flattens Sum summands
-      for (auto &subsummand : *summand) this->prepend(subsummand);
+      for (auto &prefix_summand : prefix)
+        summands_[--front_gap_] = std::move(prefix_summand);
+      if (prefix_constant_idx)  // if included the constant, locate it ...
+        constant_summand_idx_ = prefix.size() - 1 - *prefix_constant_idx;
+      else if (constant_summand_idx_)  // else update its position, if any
+        *constant_summand_idx_ += prefix.size();
     }
+    reset_hash_value();
     return *this;
   }
 
   /// Summands accessor
-  const auto &summands() const { return summands_; }
+  /// @return a view of the summands
+  std::span<const ExprPtr> summands() const {
+    return {summands_.data() + front_gap_, size()};
+  }
 
   /// Summand accessor
   /// @param i summand index
   /// @return ith summand
-  const ExprPtr &summand(size_t i) const { return summands_.at(i); }
+  const ExprPtr &summand(size_t i) const {
+    return summands_.at(front_gap_ + i);
+  }
 
   /// Takes the first @c count elements of the sum
   ExprPtr take_n(size_t count) const {
-    const auto e = (count >= summands_.size() ? summands_.end()
-                                              : (summands_.begin() + count));
-    return ex<Sum>(summands_.begin(), e);
+    const auto summands = this->summands();
+    const auto e = (count >= summands.size() ? summands.end()
+                                             : (summands.begin() + count));
+    return ex<Sum>(summands.begin(), e);
   }
 
   /// Takes the first @c count elements of the sum starting with element @c
   /// offset
   ExprPtr take_n(size_t offset, size_t count) const {
+    const auto summands = this->summands();
     const auto offset_plus_count = offset + count;
-    const auto b = (offset >= summands_.size() ? summands_.end()
-                                               : (summands_.begin() + offset));
-    const auto e = (offset_plus_count >= summands_.size()
-                        ? summands_.end()
-                        : (summands_.begin() + offset_plus_count));
+    const auto b = (offset >= summands.size() ? summands.end()
+                                              : (summands.begin() + offset));
+    const auto e = (offset_plus_count >= summands.size()
+                        ? summands.end()
+                        : (summands.begin() + offset_plus_count));
     return ex<Sum>(b, e);
   }
 
@@ -1435,14 +1477,14 @@ class Sum : public Expr {
   /// Selects elements {`e`} for which `f(e)` is true
   template <typename Filter>
   ExprPtr filter(Filter &&f) const {
-    return ex<Sum>(summands_ | ranges::views::filter(f));
+    return ex<Sum>(summands() | ranges::views::filter(f));
   }
 
   /// @return true if the number of factors is zero
-  bool empty() const { return summands_.empty(); }
+  bool empty() const { return size() == 0; }
 
   /// @return the number of summands in a Sum
-  std::size_t size() const { return summands_.size(); }
+  std::size_t size() const { return summands_.size() - front_gap_; }
 
   std::wstring to_latex() const override {
     std::wstring result;
@@ -1485,11 +1527,12 @@ class Sum : public Expr {
   };
 
   ExprPtr clone() const override {
-    auto cloned_summands =
-        summands() | ranges::views::transform(
-                         [](const ExprPtr &ptr) { return ptr->clone(); });
-    return ex<Sum>(ranges::begin(cloned_summands),
-                   ranges::end(cloned_summands));
+    auto result = ex<Sum>();
+    auto &result_sum = result.as<Sum>();
+    result_sum.summands_.reserve(size());
+    // the clones are not shared, hence can be adopted
+    for (const auto &summand : summands()) result_sum.adopt(summand->clone());
+    return result;
   }
 
   /// @brief adjoint of a Sum is a sum of adjoints of its factors
@@ -1510,24 +1553,105 @@ class Sum : public Expr {
   }
 
  private:
+  // the summands are preceded by front_gap_ null elements, to make
+  // prepend() fast
   container::svector<ExprPtr, 2> summands_{};
+  std::size_t front_gap_ = 0;
   std::optional<size_t>
       constant_summand_idx_{};  // points to the constant summand, if any; used
                                 // to sum up constants in append/prepend
 
+  /// @return the constant summand
+  /// @pre `constant_summand_idx_` is set
+  ExprPtr &constant_summand() {
+    return summands_.at(front_gap_ + *constant_summand_idx_);
+  }
+
+  /// removes the null elements preceding the summands
+  void close_front_gap() {
+    summands_.erase(summands_.begin(), summands_.begin() + front_gap_);
+    front_gap_ = 0;
+  }
+
+  /// implements append() and adopt()
+  /// @param summand the summand
+  /// @param clone whether to clone @p summand (and its summands, if it is a
+  /// Sum) or to adopt it
+  Sum &append_impl(ExprPtr &&summand, bool clone) {
+    assert(summand);
+    if (!summand->is<Sum>()) {
+      if (summand->is<Constant>()) {  // exclude zeros, add up constants
+                                      // immediately, if possible
+        if (constant_summand_idx_) {
+          add_constant(constant_summand(), *summand);
+        } else {
+          if (!summand->as<Constant>().is_zero()) {
+            summands_.push_back(clone ? summand->clone() : std::move(summand));
+            constant_summand_idx_ = size() - 1;
+          }
+        }
+      } else {
+        summands_.push_back(clone ? summand->clone() : std::move(summand));
+      }
+      reset_hash_value();
+    } else {  // this recursively flattens Sum summands
+      summands_.reserve(summands_.size() + summand->size());
+      for (auto &subsummand : *summand)
+        this->append_impl(clone ? ExprPtr(subsummand) : std::move(subsummand),
+                          clone);
+    }
+    return *this;
+  }
+
+  /// adds @p constant to the constant summand @p constant_summand, which is
+  /// cloned first if shared (e.g. with a copy of this Sum)
+  static void add_constant(ExprPtr &constant_summand, const Expr &constant) {
+    assert(constant_summand->is<Constant>());
+    if (constant_summand.use_count() != 1)
+      constant_summand = constant_summand->clone();
+    *constant_summand += constant;
+  }
+
+  /// collects the non-Sum summands of @p summand to be prepended in the
+  /// reverse order to @p prefix, adding up the constants as prepend() does
+  /// @param[in] summand the summand being prepended
+  /// @param[in,out] prefix the (cloned) summands to be prepended, in reverse
+  /// order
+  /// @param[in,out] prefix_constant_idx the position of the constant summand
+  /// in @p prefix, if any
+  void collect_prepended(const ExprPtr &summand,
+                         container::svector<ExprPtr> &prefix,
+                         std::optional<size_t> &prefix_constant_idx) {
+    if (summand->is<Sum>()) {  // this recursively flattens Sum summands
+      for (auto &subsummand : *summand)
+        collect_prepended(subsummand, prefix, prefix_constant_idx);
+    } else if (summand->is<Constant>()) {  // exclude zeros, add up constants
+      if (constant_summand_idx_) {
+        add_constant(constant_summand(), *summand);
+      } else if (prefix_constant_idx) {
+        add_constant(prefix[*prefix_constant_idx], *summand);
+      } else if (!summand->as<Constant>().is_zero()) {
+        prefix_constant_idx = prefix.size();
+        prefix.push_back(summand->clone());
+      }
+    } else {
+      prefix.push_back(summand->clone());
+    }
+  }
+
   cursor begin_cursor() override {
-    return summands_.empty() ? Expr::begin_cursor() : cursor{&summands_[0]};
+    return empty() ? Expr::begin_cursor() : cursor{&summands_[front_gap_]};
   };
   cursor end_cursor() override {
-    return summands_.empty() ? Expr::end_cursor()
-                             : cursor{&summands_[0] + summands_.size()};
+    return empty() ? Expr::end_cursor()
+                   : cursor{&summands_[0] + summands_.size()};
   };
   cursor begin_cursor() const override {
-    return summands_.empty() ? Expr::begin_cursor() : cursor{&summands_[0]};
+    return empty() ? Expr::begin_cursor() : cursor{&summands_[front_gap_]};
   };
   cursor end_cursor() const override {
-    return summands_.empty() ? Expr::end_cursor()
-                             : cursor{&summands_[0] + summands_.size()};
+    return empty() ? Expr::end_cursor()
+                   : cursor{&summands_[0] + summands_.size()};
   };
 
   hash_type memoizing_hash() const override {
@@ -1542,6 +1666,8 @@ class Sum : public Expr {
 
   /// @param multipass if true, will do a multipass canonicalization, with extra
   /// cleanup pass after the deep canonization pass
+  /// @note the summands are canonicalized concurrently (see
+  /// sequant::for_each), hence must not share subexpressions
   ExprPtr canonicalize_impl(bool multipass);
 
   virtual ExprPtr canonicalize() override { return canonicalize_impl(true); }
@@ -66,7 +66,7 @@ struct expand_visitor {
             ranges::begin(*expr), ranges::end(*expr));
         exprseq_clone_template[i].reset();
         // allocate the result, if not done yet
-        if (!result) result = std::make_shared<Sum>();
+        if (!result) result = ex<Sum>().as_shared_ptr<Sum>();
         ExprPtr subexpr_to_expand = expr_ref[i];
         for (auto& subsubexpr : *subexpr_to_expand) {
           auto exprseq_clone =
@@ -101,7 +101,7 @@ struct expand_visitor {
         // if this is the first term that was expanded, create a result and copy
         // all preceeding subexpressions into it
         if (!result && this_term_expanded) {
-          result = std::make_shared<Sum>();
+          result = ex<Sum>().as_shared_ptr<Sum>();
           for (std::size_t j = 0; j != i; ++j) result->append(expr_ref[j]);
         }
         // if expr != expanded result append current subexpr
@@ -117,7 +117,7 @@ struct expand_visitor {
         // create a result, if not yet created, by copying all preceeding
         // subexpressions into it
         if (!result) {
-          result = std::make_shared<Sum>();
+          result = ex<Sum>().as_shared_ptr<Sum>();
           for (std::size_t j = 0; j != i; ++j) result->append(expr_ref[j]);
         }
         if (result) result->append(expr_ref[i]);
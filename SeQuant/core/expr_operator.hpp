@@ -43,12 +43,12 @@ inline ExprPtr operator^(const ExprPtr &left, const ExprPtr &right) {
   if (!left_is_product && !right_is_product) {
     return ex<NCProduct>(ExprPtrList{left, right});
   } else if (left_is_product) {
-    auto result = std::make_shared<NCProduct>(left->clone().as<Product>());
-    result->append(1, right);
+    auto result = ex<NCProduct>(left->clone().as<Product>());
+    result->as<NCProduct>().append(1, right);
     return result;
   } else {  // right_is_product
-    auto result = std::make_shared<NCProduct>(right->clone().as<Product>());
-    result->prepend(1, left);
+    auto result = ex<NCProduct>(right->clone().as<Product>());
+    result->as<NCProduct>().prepend(1, left);
     return result;
   }
   abort();  // unreachable
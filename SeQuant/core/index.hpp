@@ -9,6 +9,7 @@
 #include <SeQuant/core/context.hpp>
 #include <SeQuant/core/hash.hpp>
 #include <SeQuant/core/tag.hpp>
+#include <SeQuant/core/utility/interned_string.hpp>
 #include <SeQuant/core/utility/string.hpp>
 #include <SeQuant/core/utility/swap.hpp>
 
@@ -160,10 +161,10 @@ class Index : public Taggable {
         bool symmetric_proto_indices = true)
       : symmetric_proto_indices_(symmetric_proto_indices) {
     if constexpr (!std::is_same_v<std::decay_t<IndexOrIndexLabel>, Index>) {
-      label_ = index_or_index_label;
-      space_ = get_default_context().index_space_registry()->retrieve(label_);
+      label_ = detail::InternedWString(to_wstring(index_or_index_label));
+      space_ = get_default_context().index_space_registry()->retrieve(label());
     } else {
-      label_ = index_or_index_label.label();
+      label_ = index_or_index_label.label_;
       space_ = index_or_index_label.space();
     }
     if constexpr (!std::is_same_v<std::decay_t<I>, Index>) {
@@ -203,11 +204,11 @@ class Index : public Taggable {
       : proto_indices_(std::forward<IndexContainer>(proto_indices)),
         symmetric_proto_indices_(symmetric_proto_indices) {
     if constexpr (!std::is_same_v<std::decay_t<IndexOrIndexLabel>, Index>) {
-      label_ = index_or_index_label;
+      label_ = detail::InternedWString(to_wstring(index_or_index_label));
       check_nontmp_label();
-      space_ = get_default_context().index_space_registry()->retrieve(label_);
+      space_ = get_default_context().index_space_registry()->retrieve(label());
     } else {
-      label_ = index_or_index_label.label();
+      label_ = index_or_index_label.label_;
       space_ = index_or_index_label.space();
     }
     canonicalize_proto_indices();
@@ -226,7 +227,7 @@ class Index : public Taggable {
   template <typename IndexOrIndexLabel>
   Index(IndexOrIndexLabel &&index_or_index_label, IndexSpace space) {
     if constexpr (std::is_same_v<IndexOrIndexLabel, Index>) {
-      label_ = std::move(index_or_index_label.label());
+      label_ = index_or_index_label.label_;
       space_ = std::move(space);
       proto_indices_ = std::move(index_or_index_label.proto_indices_);
       symmetric_proto_indices_ = index_or_index_label.symmetric_proto_indices_;
@@ -234,15 +235,15 @@ class Index : public Taggable {
       check_for_duplicate_proto_indices();
     } else if constexpr (std::is_same_v<std::decay_t<IndexOrIndexLabel>,
                                         Index>) {
-      label_ = index_or_index_label.label();
+      label_ = index_or_index_label.label_;
       space_ = std::move(space);
       proto_indices_ = index_or_index_label.proto_indices_;
       symmetric_proto_indices_ = index_or_index_label.symmetric_proto_indices_;
       canonicalize_proto_indices();
       check_for_duplicate_proto_indices();
     } else {
-      label_ =
-          to_wstring(std::forward<IndexOrIndexLabel>(index_or_index_label));
+      label_ = detail::InternedWString(
+          to_wstring(std::forward<IndexOrIndexLabel>(index_or_index_label)));
       space_ = std::move(space);
     }
     check_nontmp_label();
@@ -286,8 +287,8 @@ class Index : public Taggable {
   /// @return a unique temporary index in space @c space
   static Index make_tmp_index(const IndexSpace &space) {
     Index result;
-    result.label_ =
-        space.base_key() + L'_' + std::to_wstring(Index::next_tmp_index());
+    result.label_ = detail::InternedWString::transient(
+        space.interned_base_key(), Index::next_tmp_index());
     result.space_ = space;
     return result;
   }
@@ -310,8 +311,8 @@ class Index : public Taggable {
                               IndexRange &&proto_indices,
                               bool symmetric_proto_indices = true) {
     Index result;
-    result.label_ =
-        space.base_key() + L'_' + std::to_wstring(Index::next_tmp_index());
+    result.label_ = detail::InternedWString::transient(
+        space.interned_base_key(), Index::next_tmp_index());
     result.space_ = space;
     if constexpr (std::is_convertible_v<std::remove_reference_t<IndexRange>,
                                         Index::index_vector>) {
@@ -356,7 +357,11 @@ class Index : public Taggable {
   /// @note label format is `base` or `base_ordinal`
   /// @warning this does not include the proto index labels, use
   /// Index::full_label() instead
-  std::wstring_view label() const { return label_; }
+  std::wstring_view label() const { return label_.str(); }
+
+  /// @return the hash value of the label, equal to `hash::value(label())`
+  /// @note the hash value is stored with the label, hence this is O(1)
+  std::size_t label_hash() const { return label_.hash_value(); }
 
   /// @return the label split into base and ordinal parts; the ordinal part is
   /// empty, if missing
@@ -402,7 +407,7 @@ class Index : public Taggable {
   std::wstring_view full_label() const {
     if (!has_proto_indices()) return label();
     if (full_label_) return *full_label_;
-    std::wstring result = label_ + L"<";
+    std::wstring result = std::wstring(label()) + L"<";
     using namespace std::literals;
     result +=
         ranges::views::transform(proto_indices_,
@@ -723,7 +728,10 @@ class Index : public Taggable {
   };
 
  private:
-  std::wstring label_{};
+  // user-provided labels are interned (and retained for the lifetime of the
+  // program), the generated labels of temporary indices are not; labels of
+  // the form base_ordinal are compared via their integer representation
+  detail::InternedWString label_{};
   IndexSpace space_{};
   // an unordered set of unique indices on which this index depends on
   // whether proto_indices_ is symmetric w.r.t. permutations; if true,
@@ -744,7 +752,7 @@ class Index : public Taggable {
 
   /// throws std::invalid_argument if label_ is in reserved
   void check_nontmp_label() {
-    const auto index = label_index(label_);
+    const auto index = label_index(label());
     if (index && index > min_tmp_index()) {
       throw std::invalid_argument(
           "Index ctor: label index must be less than the value returned by "
@@ -767,16 +775,20 @@ class Index : public Taggable {
 
   friend class IndexFactory;
 
-  // this ctor is only used by make_tmp_index and IndexFactory and bypasses
-  // check for nontmp index
-  Index(std::wstring_view label, const IndexSpace *space) noexcept
-      : label_(label), space_(*space), proto_indices_() {}
+  // this ctor is only used by IndexFactory and bypasses check for nontmp
+  // index; makes label `space->base_key() + '_' + ordinal`, which is not
+  // interned since the number of generated labels is unbounded
+  Index(const IndexSpace *space, std::size_t ordinal)
+      : label_(detail::InternedWString::transient(space->interned_base_key(),
+                                                  ordinal)),
+        space_(*space),
+        proto_indices_() {}
 
   /// @return true if @c index1 is identical to @c index2 , i.e. they belong to
   /// the same space, they have the same label, and the same proto-indices (if
   /// any)
   friend bool operator==(const Index &i1, const Index &i2) {
-    return i1.space() == i2.space() && i1.label() == i2.label() &&
+    return i1.label_ == i2.label_ && i1.space() == i2.space() &&
            i1.proto_indices() == i2.proto_indices();
   }
 
@@ -800,7 +812,12 @@ class Index : public Taggable {
         return i1.space() < i2.space();
       }
 
-      if (i1.label() != i2.label()) {
+      if (i1.label_ != i2.label_) {
+        // labels with the same base (the common case) are ordered by their
+        // ordinals, this is equivalent to the general case below
+        if (i1.label_.base_id() && i1.label_.base_id() == i2.label_.base_id())
+          return i1.label_.ordinal() < i2.label_.ordinal();
+
         // Note: Can't simply use label1 < label2 as that won't yield expected
         // results for e.g. i2 < i11 (which will yield false)
         if (i1.label().size() != i2.label().size()) {
@@ -911,9 +928,7 @@ class IndexFactory {
           assert(inserted);
         }
       }
-      result = Index(
-          space.base_key() + L'_' + std::to_wstring(++(counter_it->second)),
-          &space);
+      result = Index(&space, ++(counter_it->second));
       valid = validator_ ? validator_(result) : true;
     } while (!valid);
     return result;
@@ -941,9 +956,7 @@ class IndexFactory {
           counter_it = counters_.find(space);
         }
       }
-      result = Index(Index(space.base_key() + L'_' +
-                               std::to_wstring(++(counter_it->second)),
-                           &space),
+      result = Index(Index(&space, ++(counter_it->second)),
                      idx.proto_indices());
       valid = validator_ ? validator_(result) : true;
     } while (!valid);
@@ -973,7 +986,8 @@ inline auto hash_value(const Index &idx) {
   using std::begin;
   using std::end;
   auto val = hash::range(begin(proto_indices), end(proto_indices));
-  hash::combine(val, idx.label());
+  // same as hash::combine(val, idx.label()), but uses the interned hash value
+  sequant_boost::hash_combine(val, idx.label_hash());
   return val;
 }
 
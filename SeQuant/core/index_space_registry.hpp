@@ -6,6 +6,7 @@
 #define SEQUANT_INDEX_SPACE_REGISTRY_HPP
 
 #include <SeQuant/core/space.hpp>
+#include <SeQuant/core/utility/atomic_shared_ptr.hpp>
 
 #include <range/v3/algorithm/sort.hpp>
 #include <range/v3/numeric/accumulate.hpp>
@@ -17,6 +18,8 @@
 #include <boost/hana.hpp>
 #include <boost/hana/ext/std/integral_constant.hpp>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 namespace sequant {
@@ -53,8 +56,10 @@ constexpr auto is_particle = IsParticle{};
 /// various spaces (vacuum, reference, complete, etc.). Copy semantics is thus
 /// partially shallow, with spaces shared between copies. This allows to have
 /// multiple registries share same set of spaces but have different
-/// specifications of vacuum, reference, etc.; this is useful for providing
+/// specifications of vacuum, reference, etc. (see
+/// IndexSpaceRegistry::sharing_spaces()); this is useful for providing
 /// different contexts for fermions and bosons, for example.
+/// The set of spaces can only be modified via the registries sharing it.
 ///
 /// Spaces that can be occupied by physical particles need to be
 /// introspected for their structure, occupancy, etc. The registry provides the
@@ -85,23 +90,28 @@ class IndexSpaceRegistry {
   /// default constructor creates a registry containing only IndexSpace::null
   /// @note null space is registered so we don't have to handle it as a corner
   /// case in retrieve() and other methods
-  IndexSpaceRegistry()
-      : spaces_(std::make_shared<
-                container::set<IndexSpace, IndexSpace::KeyCompare>>()) {
+  IndexSpaceRegistry() {
+    auto shared_spaces = std::make_shared<SharedSpaces>();
+    spaces_ = std::shared_ptr<spaces_type>(shared_spaces,
+                                           &shared_spaces->spaces);
+    spaces_version_ = std::shared_ptr<std::atomic<std::size_t>>(
+        shared_spaces, &shared_spaces->version);
     // register nullspace
     this->add(IndexSpace::null);
   }
 
-  /// constructs an IndexSpaceRegistry from an existing set of IndexSpace
-  /// objects
-  IndexSpaceRegistry(
-      std::shared_ptr<container::set<IndexSpace, IndexSpace::KeyCompare>>
-          spaces)
-      : spaces_(std::move(spaces)) {}
+  /// @param other an IndexSpaceRegistry
+  /// @return a registry that shares the set of IndexSpace objects with
+  /// @p other (hence modifying the set via either is visible to both), but
+  /// not the specification of vacuum, reference, etc.
+  static IndexSpaceRegistry sharing_spaces(const IndexSpaceRegistry& other) {
+    return IndexSpaceRegistry(other.spaces_, other.spaces_version_);
+  }
 
   /// copy constructor
   IndexSpaceRegistry(const IndexSpaceRegistry& other)
       : spaces_(other.spaces_),
+        spaces_version_(other.spaces_version_),
         physical_particle_attribute_mask_(
             other.physical_particle_attribute_mask_),
         vacocc_(other.vacocc_),
@@ -113,6 +123,7 @@ class IndexSpaceRegistry {
   /// move constructor
   IndexSpaceRegistry(IndexSpaceRegistry&& other)
       : spaces_(std::move(other.spaces_)),
+        spaces_version_(std::move(other.spaces_version_)),
         physical_particle_attribute_mask_(
             std::move(other.physical_particle_attribute_mask_)),
         vacocc_(std::move(other.vacocc_)),
@@ -124,6 +135,7 @@ class IndexSpaceRegistry {
   /// copy assignment operator
   IndexSpaceRegistry& operator=(const IndexSpaceRegistry& other) {
     spaces_ = other.spaces_;
+    spaces_version_ = other.spaces_version_;
     physical_particle_attribute_mask_ = other.physical_particle_attribute_mask_;
     vacocc_ = other.vacocc_;
     refocc_ = other.refocc_;
@@ -136,6 +148,7 @@ class IndexSpaceRegistry {
   /// move assignment operator
   IndexSpaceRegistry& operator=(IndexSpaceRegistry&& other) {
     spaces_ = std::move(other.spaces_);
+    spaces_version_ = std::move(other.spaces_version_);
     physical_particle_attribute_mask_ =
         std::move(other.physical_particle_attribute_mask_);
     vacocc_ = std::move(other.vacocc_);
@@ -146,7 +159,13 @@ class IndexSpaceRegistry {
     return *this;
   }
 
-  const auto& spaces() const { return spaces_; }
+  /// the type of the set of IndexSpace objects
+  using spaces_type = container::set<IndexSpace, IndexSpace::KeyCompare>;
+
+  /// @return the set of registered IndexSpace objects
+  /// @note the set is shared with the copies of this, and can only be
+  /// modified via the registries sharing it
+  std::shared_ptr<const spaces_type> spaces() const { return spaces_; }
 
   decltype(auto) begin() const { return spaces_->cbegin(); }
   decltype(auto) end() const { return spaces_->cend(); }
@@ -196,10 +215,7 @@ class IndexSpaceRegistry {
   /// not found
   const IndexSpace* retrieve_ptr(const IndexSpace::Type& type,
                                  const IndexSpace::QuantumNumbers& qns) const {
-    auto it = std::find_if(
-        spaces_->begin(), spaces_->end(),
-        [&](const auto& is) { return is.type() == type && is.qns() == qns; });
-    return it != spaces_->end() ? &(*it) : nullptr;
+    return find_ptr_by_attr({type, qns});
   }
 
   /// @brief retrieve an IndexSpace from the registry by its type and quantum
@@ -225,10 +241,7 @@ class IndexSpaceRegistry {
   /// @return pointer to the IndexSpace associated with that key, or nullptr if
   /// not found
   const IndexSpace* retrieve_ptr(const IndexSpace::Attr& space_attr) const {
-    auto it = std::find_if(
-        spaces_->begin(), spaces_->end(),
-        [&space_attr](const IndexSpace& s) { return s.attr() == space_attr; });
-    return it != spaces_->end() ? &(*it) : nullptr;
+    return find_ptr_by_attr(space_attr);
   }
 
   /// @brief retrieve an IndexSpace from the registry by the IndexSpace::Attr
@@ -1187,36 +1200,103 @@ class IndexSpaceRegistry {
 
  private:
   // N.B. need transparent comparator, see https://stackoverflow.com/a/35525806
-  std::shared_ptr<container::set<IndexSpace, IndexSpace::KeyCompare>> spaces_;
+  std::shared_ptr<spaces_type> spaces_;
+  // identifies the contents of spaces_, hence is shared by the registries
+  // sharing spaces_ ; the values are drawn from a global counter, hence the
+  // memoized data of any registry can be validated against it
+  std::shared_ptr<std::atomic<std::size_t>> spaces_version_;
+
+  // the set of spaces and its version, allocated together
+  struct SharedSpaces {
+    spaces_type spaces;
+    std::atomic<std::size_t> version{next_spaces_version()};
+  };
+
+  IndexSpaceRegistry(std::shared_ptr<spaces_type> spaces,
+                     std::shared_ptr<std::atomic<std::size_t>> spaces_version)
+      : spaces_(std::move(spaces)),
+        spaces_version_(std::move(spaces_version)) {}
+
+  /// @return a new value of spaces_version_
+  static std::size_t next_spaces_version() {
+    static std::atomic<std::size_t> version = 0;
+    return ++version;
+  }
 
   bitset_t physical_particle_attribute_mask_ = bitset::null;
 
   // memoized data
   mutable std::shared_ptr<std::vector<IndexSpace::Type>> base_space_types_;
   mutable std::shared_ptr<std::vector<IndexSpace>> base_spaces_;
+  // maps attributes (cast to int64_t) of the registered spaces to their
+  // positions in spaces_
+  struct AttrIndex {
+    std::size_t spaces_version;  // the value of *spaces_version_ it is for
+    container::map<int64_t, std::size_t> positions;
+  };
+  // N.B. read concurrently by lookups, hence loaded and replaced atomically
+  mutable AtomicSharedPtr<const AttrIndex> attr_index_;
   mutable std::recursive_mutex
       mtx_memoized_;  // used to update the memoized data
   IndexSpaceRegistry& clear_memoized_data_and_return_this() {
+    // N.B. invalidates the memoized data of the registries sharing spaces_
+    // also
+    spaces_version_->store(next_spaces_version(), std::memory_order_release);
     std::scoped_lock guard{mtx_memoized_};
     base_space_types_.reset();
     base_spaces_.reset();
+    attr_index_.store(nullptr);
     return *this;
   }
 
+  /// @return (memoized) map from the attributes of the registered spaces to
+  /// their positions in spaces_ ; since the attributes of the registered
+  /// spaces are unique, this makes lookups by attribute O(log N) integer
+  /// comparisons
+  /// @note recomputed if spaces_ was modified via this or via a registry
+  /// sharing it
+  /// @note the returned snapshot is immutable, hence can be used while other
+  /// threads look up spaces also
+  std::shared_ptr<const AttrIndex> attr_index() const {
+    const auto version = spaces_version_->load(std::memory_order_acquire);
+    auto index = attr_index_.load();
+    if (!index || index->spaces_version != version) {
+      container::map<int64_t, std::size_t> positions;
+      positions.reserve(spaces_->size());
+      std::size_t pos = 0;
+      for (auto&& space : *spaces_)
+        positions.emplace(int64_t(space.attr()), pos++);
+      index = std::make_shared<const AttrIndex>(
+          AttrIndex{version, std::move(positions)});
+      attr_index_.store(index);
+    }
+    return index;
+  }
+
   ///@brief true if has one and only one bit set.
   static bool has_single_bit(std::uint32_t bits) {
     return bits && !(bits & (bits - 1));
   }
 
+  /// @brief find an IndexSpace from its attr
+  /// @param attr the attribute of the IndexSpace
+  /// @return pointer to the IndexSpace, or nullptr if not present
+  const IndexSpace* find_ptr_by_attr(const IndexSpace::Attr& attr) const {
+    const auto index = attr_index();
+    const auto& positions = index->positions;
+    if (auto it = positions.find(int64_t(attr)); it != positions.end()) {
+      const auto& space = *spaces_->nth(it->second);
+      assert(space.attr() == attr);
+      return &space;
+    }
+    return nullptr;
+  }
+
   /// @brief find an IndexSpace from its attr. return nullspace if not present.
   /// @param attr the attribute of the IndexSpace
   const IndexSpace& find_by_attr(const IndexSpace::Attr& attr) const {
-    for (auto&& space : *spaces_) {
-      if (space.attr() == attr) {
-        return space;
-      }
-    }
-    return IndexSpace::null;
+    const auto* ptr = find_ptr_by_attr(attr);
+    return ptr ? *ptr : IndexSpace::null;
   }
 
   void throw_if_missing(const IndexSpace::Type& t,
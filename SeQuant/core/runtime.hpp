@@ -5,26 +5,24 @@
 #ifndef SEQUANT_RUNTIME_HPP
 #define SEQUANT_RUNTIME_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include <SeQuant/core/ranges.hpp>
-
-#ifdef SEQUANT_HAS_EXECUTION_HEADER
-#include <execution>
-#else
-#include <atomic>
-#include <mutex>
-#endif
+#include <SeQuant/core/utility/thread_pool.hpp>
 
 namespace sequant {
 
 namespace detail {
-inline int& nthreads_accessor() {
+inline std::atomic<int>& nthreads_accessor() {
   auto init_nthreads = []() {
     const auto nthreads_cstr = std::getenv("SEQUANT_NUM_THREADS");
     int nthreads = nthreads_cstr ? std::atoi(nthreads_cstr)
@@ -33,51 +31,54 @@ inline int& nthreads_accessor() {
                                         : 1);
     return nthreads;
   };
-  static int nthreads = init_nthreads();
+  static std::atomic<int> nthreads = init_nthreads();
   return nthreads;
 }
 }  // namespace detail
 
 /// sets the number of threads to use for concurrent work
+/// @note the persistent thread pool (see detail::ThreadPool) is resized on
+/// the next parallel call; can be called concurrently with parallel work
 inline void set_num_threads(int nt) {
   if (nt < 1)
     throw std::invalid_argument("set_num_threads(nthreads): invalid nthreads");
-  detail::nthreads_accessor() = nt;
+  detail::nthreads_accessor().store(nt, std::memory_order_relaxed);
 }
 
 /// @return the number of threads to use for concurrent work
 /// @note by default use the value returned std::thread::hardware_concurrency()
 /// if available, otherwise 1
 /// @sa set_num_threads()
-inline int num_threads() { return detail::nthreads_accessor(); }
+inline int num_threads() {
+  return detail::nthreads_accessor().load(std::memory_order_relaxed);
+}
 
-/// Fires off @c nthreads instances of lambda in parallel, each in its own
-/// thread (thus @c nthreads-1 std::thread objects are created), where @c
-/// nthreads is the value returned by get_num_threads() .
+/// Fires off @c nthreads instances of lambda in parallel, where @c nthreads
+/// is the value returned by num_threads() . The instances are executed by the
+/// calling thread and the workers of the persistent thread pool (see
+/// detail::ThreadPool), hence no threads are created.
 /// @tparam Lambda a function type for which @c Lambda(int) is valid
 /// @param lambda the function object to execute, each will be invoked as @c
 /// lambda(thread_id) where @c thread_id is an integer in
 ///        @c [0,nthreads) .
-/// @sa get_num_threads()
+/// @warning the instances are not guaranteed to execute concurrently (e.g.
+/// if called from within a parallel region), hence they must not wait for
+/// each other
+/// @sa num_threads()
 template <typename Lambda>
 void parallel_do(Lambda&& lambda) {
-  std::vector<std::thread> threads;
   const auto nthreads = num_threads();
-  for (int thread_id = 0; thread_id != nthreads; ++thread_id) {
-    if (thread_id != nthreads - 1)
-      threads.push_back(std::thread(std::forward<Lambda>(lambda), thread_id));
-    else
-      std::forward<Lambda>(lambda)(thread_id);
-  }  // threads_id
-  for (int thread_id = 0; thread_id < nthreads - 1; ++thread_id)
-    threads[thread_id].join();
+  detail::TaskGroup tasks;
+  for (int thread_id = 0; thread_id != nthreads - 1; ++thread_id)
+    tasks.run([&lambda, thread_id]() { lambda(thread_id); });
+  std::forward<Lambda>(lambda)(nthreads - 1);
+  tasks.wait();
 }
 
-/// Parallel version of std::for_each , using either parallel C++ algorithms
-/// or manual threaded implementation with at most
-/// @c nthreads instances executing concurrently, where @c nthreads is the value
-/// returned by get_num_threads() .
-/// @tparam SizedRange a sied range
+/// Parallel version of std::for_each , executed by the persistent thread pool
+/// (see detail::ThreadPool) with at most @c nthreads instances executing
+/// concurrently, where @c nthreads is the value returned by num_threads() .
+/// @tparam SizedRange a sized range
 /// @tparam UnaryOp a function type for which @c Lambda(int) is valid
 /// @param rng the \p SizedRange object
 /// @param op the function object to execute, each will be invoked as
@@ -85,16 +86,16 @@ void parallel_do(Lambda&& lambda) {
 ///        @c [0,size(rng)) . @c op(t1) will be commenced not
 /// after @c op(t2) if @c t1<t2 .
 /// @note The load is balanced dynamically.
-/// @sa get_num_threads()
+/// @note Can be called from within @p op (or any other task executed by the
+/// thread pool), in which case the nested loop is executed by the same pool.
+/// @sa num_threads()
 template <typename SizedRange, typename UnaryOp>
 void for_each(SizedRange& rng, const UnaryOp& op) {
-  using ranges::begin;
-  using ranges::end;
-#ifdef SEQUANT_HAS_EXECUTION_HEADER
-  std::for_each(std::execution::par_unseq, begin(rng), end(rng), op);
-#else
+  const std::size_t ntasks = ranges::size(rng);
+  if (ntasks == 0) return;
+
   std::atomic<size_t> work = 0;
-  auto task = [&work, &op, &rng, ntasks = ranges::size(rng)]() {
+  auto task = [&work, &op, &rng, ntasks]() {
     auto it = ranges::begin(rng);
     size_t prev_task_id = 0;
     size_t task_id = work.fetch_add(1);
@@ -106,21 +107,16 @@ void for_each(SizedRange& rng, const UnaryOp& op) {
     }
   };
 
-  const auto nthreads = num_threads();
-  std::vector<std::thread> threads;
-  for (int thread_id = 0; thread_id != nthreads; ++thread_id) {
-    if (thread_id != nthreads - 1)
-      threads.push_back(std::thread(task));
-    else
-      task();
-  }  // threads_id
-  for (int thread_id = 0; thread_id < nthreads - 1; ++thread_id)
-    threads[thread_id].join();
-#endif
+  detail::TaskGroup tasks;
+  const auto nhelpers = std::min(tasks.pool().nworkers(), ntasks - 1);
+  for (std::size_t h = 0; h != nhelpers; ++h) tasks.run(task);
+  task();
+  tasks.wait();
 }
 
 /// Does map+reduce (i.e., std::transform_reduce) on a range
-/// using up to get_num_threads() threads.
+/// using up to num_threads() threads of the persistent thread pool (see
+/// detail::ThreadPool).
 /// @tparam SizedRange a sized range
 /// @tparam BinaryReductionOp a function type such that
 /// `reduce(identity,map(*begin(rng)))`, where `reduce` and `identity` are
@@ -132,47 +128,53 @@ void for_each(SizedRange& rng, const UnaryOp& op) {
 /// @param init the initial value for reduction
 /// @param reduce the \p ReduceLambda object
 /// @param map the \p MapLambda object
-/// @sa get_num_threads()
+/// @note as for std::transform_reduce @p reduce must be associative, since
+/// each thread reduces its items into a partial result, and the partial
+/// results are reduced (in a fixed order) by the calling thread
+/// @note the running reduction result is passed to @p reduce as an rvalue,
+/// hence @p reduce can accumulate into it in place
+/// @sa num_threads()
 template <typename SizedRange, typename T, typename BinaryReductionOp,
           typename UnaryMapOp>
 T transform_reduce(SizedRange&& rng, T init, const BinaryReductionOp& reduce,
                    const UnaryMapOp& map) {
-  using ranges::begin;
-  using ranges::end;
-#ifdef SEQUANT_HAS_EXECUTION_HEADER
-  return std::transform_reduce(std::execution::par_unseq, begin(rng), end(rng),
-                               init, reduce, map);
-#else
+  const std::size_t ntasks = ranges::size(rng);
+  if (ntasks == 0) return init;
+
+  detail::TaskGroup tasks;
+  const auto nhelpers = std::min(tasks.pool().nworkers(), ntasks - 1);
+
+  // partial results, one per participating thread, no locking needed
+  std::vector<std::optional<T>> partial_results(nhelpers + 1);
   std::atomic<size_t> work = 0;
-  std::mutex mtx;
-  T result = init;
-  auto task = [&work, &map, &reduce, &rng, &mtx, &result,
-               ntasks = ranges::size(rng)]() {
+  auto task = [&work, &map, &reduce, &rng, &partial_results,
+               ntasks](std::size_t participant_id) {
+    auto& partial_result = partial_results[participant_id];
+    auto it = ranges::begin(rng);
+    size_t prev_task_id = 0;
     size_t task_id = work.fetch_add(1);
     while (task_id < ntasks) {
-      const auto& item = rng[task_id];
-      auto mapped_item = map(item);
-      {  // critical section
-        std::scoped_lock<std::mutex> lock(mtx);
-        result = reduce(result, mapped_item);
-      }
+      std::advance(it, task_id - prev_task_id);
+      if (partial_result)
+        partial_result = reduce(std::move(*partial_result), map(*it));
+      else
+        partial_result.emplace(map(*it));
+      prev_task_id = task_id;
       task_id = work.fetch_add(1);
     }
   };
 
-  const auto nthreads = num_threads();
-  std::vector<std::thread> threads;
-  for (int thread_id = 0; thread_id != nthreads; ++thread_id) {
-    if (thread_id != nthreads - 1)
-      threads.push_back(std::thread(task));
-    else
-      task();
-  }  // threads_id
-  for (int thread_id = 0; thread_id < nthreads - 1; ++thread_id)
-    threads[thread_id].join();
+  for (std::size_t h = 0; h != nhelpers; ++h)
+    tasks.run([&task, h]() { task(h + 1); });
+  task(0);
+  tasks.wait();
 
+  T result = std::move(init);
+  for (auto& partial_result : partial_results) {
+    if (partial_result)
+      result = reduce(std::move(result), std::move(*partial_result));
+  }
   return result;
-#endif
 }
 
 void set_locale();
@@ -9,6 +9,7 @@
 
 #include <SeQuant/core/attr.hpp>
 #include <SeQuant/core/container.hpp>
+#include <SeQuant/core/utility/interned_string.hpp>
 #include <SeQuant/core/utility/string.hpp>
 #include <SeQuant/core/wstring.hpp>
 
@@ -424,7 +425,9 @@ class IndexSpace {
   IndexSpace &operator=(const IndexSpace &other) = default;
   IndexSpace &operator=(IndexSpace &&other) = default;
 
-  const std::wstring &base_key() const { return base_key_; }
+  const std::wstring &base_key() const { return base_key_.str(); }
+  /// @return the base key as stored, i.e. interned
+  const detail::InternedWString &interned_base_key() const { return base_key_; }
   static std::wstring_view reduce_key(std::wstring_view key) {
     const auto underscore_position = key.rfind(L'_');
     if (underscore_position != std::wstring::npos) {  // key can be reduced
@@ -450,7 +453,8 @@ class IndexSpace {
 
  private:
   Attr attr_;
-  std::wstring base_key_;
+  // interned, hence copies do not allocate and equality is O(1)
+  detail::InternedWString base_key_;
   std::size_t approximate_size_;
 
   static std::wstring to_wstring(std::wstring_view key) {
@@ -491,8 +495,8 @@ inline bool includes(const IndexSpace &space1, const IndexSpace &space2) {
 ///
 [[nodiscard]] inline constexpr bool operator==(
     IndexSpace const &space1, IndexSpace const &space2) noexcept {
-  return space1.type() == space2.type() && space1.qns() == space2.qns() &&
-         space1.base_key() == space2.base_key();
+  return space1.attr() == space2.attr() &&
+         space1.base_key_ == space2.base_key_;
 }
 
 ///
@@ -95,6 +95,26 @@ class Tensor : public Expr, public AbstractTensor, public Labeled {
   // list of friends who can make Tensor objects with reserved labels
   friend ExprPtr make_overlap(const Index &bra_index, const Index &ket_index);
 
+  /// @name statically-dispatched counterparts of _{bra,ket,aux}_mutable()
+  /// @note these are used by TensorCanonicalizer to avoid the type-erased
+  ///       AbstractTensor interface
+  /// @{
+  index_container_type &bra_mutable() {
+    this->reset_hash_value();
+    return bra_;
+  }
+  index_container_type &ket_mutable() {
+    this->reset_hash_value();
+    return ket_;
+  }
+  index_container_type &aux_mutable() {
+    this->reset_hash_value();
+    return aux_;
+  }
+  /// @}
+
+  friend class TensorCanonicalizer;
+
   template <typename IndexRange1, typename IndexRange2, typename IndexRange3,
             typename = std::enable_if_t<
                 (meta::is_statically_castable_v<
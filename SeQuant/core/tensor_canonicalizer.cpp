@@ -7,9 +7,14 @@
 #include <SeQuant/core/expr.hpp>
 #include <SeQuant/core/index.hpp>
 #include <SeQuant/core/meta.hpp>
+#include <SeQuant/core/tensor.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <string>
 #include <type_traits>
 
 #include <range/v3/functional/identity.hpp>
@@ -161,13 +166,59 @@ struct TensorIndexComparer {
 
 TensorCanonicalizer::~TensorCanonicalizer() = default;
 
-std::pair<container::map<std::wstring, std::shared_ptr<TensorCanonicalizer>>*,
-          std::unique_lock<std::recursive_mutex>>
-TensorCanonicalizer::instance_map_accessor() {
-  static container::map<std::wstring, std::shared_ptr<TensorCanonicalizer>>
-      map_;
-  static std::recursive_mutex mtx_;
-  return std::make_pair(&map_, std::unique_lock<std::recursive_mutex>{mtx_});
+namespace {
+
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+template <typename T>
+using SnapshotHolder = std::atomic<std::shared_ptr<const T>>;
+template <typename T>
+std::shared_ptr<const T> load(const SnapshotHolder<T>& holder) {
+  return holder.load();
+}
+template <typename T>
+void store(SnapshotHolder<T>& holder, std::shared_ptr<const T> arg) {
+  holder.store(std::move(arg));
+}
+#else
+template <typename T>
+using SnapshotHolder = std::shared_ptr<const T>;
+template <typename T>
+std::shared_ptr<const T> load(const SnapshotHolder<T>& holder) {
+  return std::atomic_load(&holder);
+}
+template <typename T>
+void store(SnapshotHolder<T>& holder, std::shared_ptr<const T> arg) {
+  std::atomic_store(&holder, std::move(arg));
+}
+#endif
+
+// the registry is read on every tensor canonicalization but rarely modified,
+// hence readers get an immutable snapshot, and writers replace it
+template <typename InstanceMap>
+SnapshotHolder<InstanceMap>& instance_map_holder() {
+  static SnapshotHolder<InstanceMap> holder{
+      std::make_shared<const InstanceMap>()};
+  return holder;
+}
+
+}  // namespace
+
+std::shared_ptr<const TensorCanonicalizer::instance_map_t>
+TensorCanonicalizer::instance_map() {
+  return load(instance_map_holder<instance_map_t>());
+}
+
+void TensorCanonicalizer::update_instance_map(
+    const std::function<void(instance_map_t&)>& op) {
+  // used to serialize the updates
+  static std::mutex mtx;
+  std::scoped_lock<std::mutex> lock(mtx);
+  auto& holder = instance_map_holder<instance_map_t>();
+  auto new_map = std::make_shared<instance_map_t>(*load(holder));
+  op(*new_map);
+  store(holder, std::shared_ptr<const instance_map_t>(std::move(new_map)));
+  ++epoch_accessor();
 }
 
 container::vector<std::wstring>&
@@ -176,11 +227,16 @@ TensorCanonicalizer::cardinal_tensor_labels_accessor() {
   return ctlabels_;
 }
 
+std::atomic<std::size_t>& TensorCanonicalizer::epoch_accessor() {
+  static std::atomic<std::size_t> epoch_ = 0;
+  return epoch_;
+}
+
 std::shared_ptr<TensorCanonicalizer>
 TensorCanonicalizer::nondefault_instance_ptr(std::wstring_view label) {
-  auto&& [map_ptr, lock] = instance_map_accessor();
+  const auto map_ptr = instance_map();
   // look for label-specific canonicalizer
-  auto it = map_ptr->find(std::wstring{label});
+  auto it = map_ptr->find(label);
   if (it != map_ptr->end()) {
     return it->second;
   } else
@@ -189,10 +245,13 @@ TensorCanonicalizer::nondefault_instance_ptr(std::wstring_view label) {
 
 std::shared_ptr<TensorCanonicalizer> TensorCanonicalizer::instance_ptr(
     std::wstring_view label) {
-  auto result = nondefault_instance_ptr(label);
-  if (!result)  // not found? look for default
-    result = nondefault_instance_ptr(L"");
-  return result;
+  // N.B. use same snapshot for both lookups
+  const auto map_ptr = instance_map();
+  auto it = map_ptr->find(label);
+  if (it == map_ptr->end())  // not found? look for default
+    it = map_ptr->find(std::wstring_view{});
+  return it != map_ptr->end() ? it->second
+                              : std::shared_ptr<TensorCanonicalizer>{};
 }
 
 std::shared_ptr<TensorCanonicalizer> TensorCanonicalizer::instance(
@@ -207,26 +266,27 @@ std::shared_ptr<TensorCanonicalizer> TensorCanonicalizer::instance(
 
 void TensorCanonicalizer::register_instance(
     std::shared_ptr<TensorCanonicalizer> can, std::wstring_view label) {
-  auto&& [map_ptr, lock] = instance_map_accessor();
-  (*map_ptr)[std::wstring{label}] = can;
+  update_instance_map([&](instance_map_t& map) {
+    map.insert_or_assign(std::wstring{label}, std::move(can));
+  });
 }
 
 bool TensorCanonicalizer::try_register_instance(
     std::shared_ptr<TensorCanonicalizer> can, std::wstring_view label) {
-  auto&& [map_ptr, lock] = instance_map_accessor();
-  if (!map_ptr->contains(std::wstring{label})) {
-    (*map_ptr)[std::wstring{label}] = can;
-    return true;
-  } else
-    return false;
+  bool inserted = false;
+  update_instance_map([&](instance_map_t& map) {
+    inserted = map.try_emplace(std::wstring{label}, std::move(can)).second;
+  });
+  return inserted;
 }
 
 void TensorCanonicalizer::deregister_instance(std::wstring_view label) {
-  auto&& [map_ptr, lock] = instance_map_accessor();
-  auto it = map_ptr->find(std::wstring{label});
-  if (it != map_ptr->end()) {
-    map_ptr->erase(it);
-  }
+  update_instance_map([&](instance_map_t& map) {
+    auto it = map.find(label);
+    if (it != map.end()) {
+      map.erase(it);
+    }
+  });
 }
 
 TensorCanonicalizer::index_comparer_t TensorCanonicalizer::index_comparer_ =
@@ -242,6 +302,7 @@ TensorCanonicalizer::index_comparer() {
 
 void TensorCanonicalizer::index_comparer(index_comparer_t comparer) {
   index_comparer_ = std::move(comparer);
+  ++epoch_accessor();
 }
 
 const TensorCanonicalizer::index_pair_comparer_t&
@@ -251,10 +312,23 @@ TensorCanonicalizer::index_pair_comparer() {
 
 void TensorCanonicalizer::index_pair_comparer(index_pair_comparer_t comparer) {
   index_pair_comparer_ = std::move(comparer);
+  ++epoch_accessor();
 }
 
 ExprPtr NullTensorCanonicalizer::apply(AbstractTensor&) const { return {}; }
 
+namespace {
+
+/// invokes @p f with @p t cast to Tensor, if possible, to make the index
+/// accesses statically dispatched, else with @p t itself
+template <typename F>
+decltype(auto) visit_tensor(AbstractTensor& t, F&& f) {
+  if (auto* tensor = dynamic_cast<Tensor*>(&t)) return f(*tensor);
+  return f(t);
+}
+
+}  // namespace
+
 void DefaultTensorCanonicalizer::tag_indices(AbstractTensor& t) const {
   // tag all indices as ext->true/ind->false
   ranges::for_each(indices(t), [this](auto& idx) {
@@ -265,15 +339,27 @@ void DefaultTensorCanonicalizer::tag_indices(AbstractTensor& t) const {
   });
 }
 
+void DefaultTensorCanonicalizer::tag_indices(Tensor& t) const {
+  // same as above, but iterates over the indices of t directly
+  ranges::for_each(t.const_indices(), [this](const Index& idx) {
+    auto it = external_indices_.find(std::wstring(idx.label()));
+    auto is_ext = it != external_indices_.end();
+    idx.tag().assign(
+        is_ext ? 0 : 1);  // ext -> 0, int -> 1, so ext will come before
+  });
+}
+
 ExprPtr DefaultTensorCanonicalizer::apply(AbstractTensor& t) const {
-  tag_indices(t);
+  return visit_tensor(t, [this](auto& tensor) {
+    tag_indices(tensor);
 
-  auto result =
-      this->apply(t, this->index_comparer_, this->index_pair_comparer_);
+    auto result =
+        this->apply(tensor, this->index_comparer_, this->index_pair_comparer_);
 
-  reset_tags(t);
+    reset_tags(tensor);
 
-  return result;
+    return result;
+  });
 }
 
 template <typename Callable, typename... Args>
@@ -281,14 +367,16 @@ using suitable_call_operator =
     decltype(std::declval<Callable>()(std::declval<Args>()...));
 
 ExprPtr TensorBlockCanonicalizer::apply(AbstractTensor& t) const {
-  tag_indices(t);
+  return visit_tensor(t, [this](auto& tensor) {
+    tag_indices(tensor);
 
-  auto result = DefaultTensorCanonicalizer::apply(t, TensorBlockIndexComparer{},
-                                                  TensorBlockIndexComparer{});
+    auto result = DefaultTensorCanonicalizer::apply(
+        tensor, TensorBlockIndexComparer{}, TensorBlockIndexComparer{});
 
-  reset_tags(t);
+    reset_tags(tensor);
 
-  return result;
+    return result;
+  });
 }
 
 }  // namespace sequant
@@ -7,9 +7,15 @@
 
 #include "abstract_tensor.hpp"
 #include "expr.hpp"
+#include "tensor.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace sequant {
 
@@ -77,8 +83,14 @@ class TensorCanonicalizer {
   static void set_cardinal_tensor_labels(
       const container::vector<std::wstring>& labels) {
     cardinal_tensor_labels_accessor() = labels;
+    ++epoch_accessor();
   }
 
+  /// @return the counter of modifications of the global canonicalization
+  /// settings (registered canonicalizers, cardinal tensor labels, and index
+  /// comparers); used to invalidate memoized canonical forms
+  static std::size_t epoch() { return epoch_accessor().load(); }
+
   /// @return a side effect of canonicalization (e.g. phase), or nullptr if none
   /// @internal what should be returned if canonicalization requires
   /// complex conjugation? Special ExprPtr type (e.g. ConjOp)? Or the actual
@@ -103,6 +115,11 @@ class TensorCanonicalizer {
   inline auto bra_range(AbstractTensor& t) const { return t._bra_mutable(); }
   inline auto ket_range(AbstractTensor& t) const { return t._ket_mutable(); }
   inline auto aux_range(AbstractTensor& t) const { return t._aux_mutable(); }
+  /// these overloads give direct access to the indices of a Tensor, bypassing
+  /// the type-erased ranges of the AbstractTensor interface
+  inline auto& bra_range(Tensor& t) const { return t.bra_mutable(); }
+  inline auto& ket_range(Tensor& t) const { return t.ket_mutable(); }
+  inline auto& aux_range(Tensor& t) const { return t.aux_mutable(); }
 
   /// the object used to compare indices
   static index_comparer_t index_comparer_;
@@ -110,11 +127,20 @@ class TensorCanonicalizer {
   static index_pair_comparer_t index_pair_comparer_;
 
  private:
-  static std::pair<
-      container::map<std::wstring, std::shared_ptr<TensorCanonicalizer>>*,
-      std::unique_lock<std::recursive_mutex>>
-  instance_map_accessor();  // map* + locked recursive mutex
+  /// maps labels to canonicalizers; the transparent comparer allows lookups
+  /// by std::wstring_view
+  using instance_map_t =
+      container::map<std::wstring, std::shared_ptr<TensorCanonicalizer>,
+                     std::less<>>;
+  /// @return the current snapshot of the registry; this does not lock, hence
+  /// lookups do not serialize concurrent canonicalizations
+  static std::shared_ptr<const instance_map_t> instance_map();
+  /// replaces the registry by a copy of the current snapshot modified by
+  /// @p op ; the updates are serialized
+  static void update_instance_map(
+      const std::function<void(instance_map_t&)>& op);
   static container::vector<std::wstring>& cardinal_tensor_labels_accessor();
+  static std::atomic<std::size_t>& epoch_accessor();
 };
 
 /// @brief null Tensor canonicalizer does nothing
@@ -153,9 +179,12 @@ class DefaultTensorCanonicalizer : public TensorCanonicalizer {
 
   /// Core of DefaultTensorCanonicalizer::apply, only does the canonicalization,
   /// i.e. no tagging/untagging
-  template <typename IndexComp, typename IndexPairComp>
-  ExprPtr apply(AbstractTensor& t, const IndexComp& idxcmp,
+  /// @tparam TensorT AbstractTensor or Tensor; the latter has its indices
+  /// accessed directly, rather than via the AbstractTensor interface
+  template <typename TensorT, typename IndexComp, typename IndexPairComp>
+  ExprPtr apply(TensorT& t, const IndexComp& idxcmp,
                 const IndexPairComp& paircmp) const {
+    static_assert(std::is_base_of_v<AbstractTensor, TensorT>);
     // std::wcout << "abstract tensor: " << to_latex(t) << "\n";
 
     // nothing to do for non-particle-symmetric tensors
@@ -181,8 +210,8 @@ class DefaultTensorCanonicalizer : public TensorCanonicalizer {
     switch (s) {
       case Symmetry::antisymm:
       case Symmetry::symm: {
-        auto _bra = bra_range(t);
-        auto _ket = ket_range(t);
+        auto&& _bra = bra_range(t);
+        auto&& _ket = ket_range(t);
         //      std::wcout << "canonicalizing " << to_latex(t);
         reset_ts_swap_counter<Index>();
         // std::{stable_}sort does not necessarily use swap! so must implement
@@ -198,8 +227,8 @@ class DefaultTensorCanonicalizer : public TensorCanonicalizer {
       case Symmetry::nonsymm: {
         // sort particles with bra and ket functions first,
         // then the particles with either bra or ket index
-        auto _bra = bra_range(t);
-        auto _ket = ket_range(t);
+        auto&& _bra = bra_range(t);
+        auto&& _ket = ket_range(t);
         auto _zip_braket = zip(take(_bra, _rank), take(_ket, _rank));
         bubble_sort(begin(_zip_braket), end(_zip_braket), paircmp);
         if (_bra_rank > _rank) {
@@ -231,6 +260,7 @@ class DefaultTensorCanonicalizer : public TensorCanonicalizer {
 
  protected:
   void tag_indices(AbstractTensor& t) const;
+  void tag_indices(Tensor& t) const;
 };
 
 class TensorBlockCanonicalizer : public DefaultTensorCanonicalizer {
@@ -0,0 +1,111 @@
+#include <SeQuant/core/tensor_network/canonical_form_cache.hpp>
+
+#include <SeQuant/core/hash.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace sequant {
+
+namespace {
+// the instance is read by every TensorNetworkV2 canonicalization but rarely
+// replaced, hence it is held as an atomic shared_ptr so that readers need not
+// lock
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+using InstanceHolder = std::atomic<std::shared_ptr<CanonicalFormCache>>;
+std::shared_ptr<CanonicalFormCache> load(const InstanceHolder &holder) {
+  return holder.load();
+}
+void store(InstanceHolder &holder, std::shared_ptr<CanonicalFormCache> arg) {
+  holder.store(std::move(arg));
+}
+#else
+using InstanceHolder = std::shared_ptr<CanonicalFormCache>;
+std::shared_ptr<CanonicalFormCache> load(const InstanceHolder &holder) {
+  return std::atomic_load(&holder);
+}
+void store(InstanceHolder &holder, std::shared_ptr<CanonicalFormCache> arg) {
+  std::atomic_store(&holder, std::move(arg));
+}
+#endif
+
+InstanceHolder &instance_accessor() {
+  static InstanceHolder instance{std::make_shared<CanonicalFormCache>()};
+  return instance;
+}
+}  // namespace
+
+std::size_t CanonicalFormCache::KeyView::hash_value() const {
+  std::size_t seed = colors.size();
+  hash::range(seed, colors.begin(), colors.end());
+  for (const auto &[v1, v2] : edges) {
+    hash::combine(seed, v1);
+    hash::combine(seed, v2);
+  }
+  return seed;
+}
+
+CanonicalFormCache::CanonicalFormCache(std::size_t max_size)
+    : max_size_(max_size) {}
+
+std::shared_ptr<CanonicalFormCache> CanonicalFormCache::instance() {
+  return load(instance_accessor());
+}
+
+void CanonicalFormCache::set_instance(
+    std::shared_ptr<CanonicalFormCache> cache) {
+  store(instance_accessor(), std::move(cache));
+}
+
+std::shared_ptr<const CanonicalFormCache::Permutation> CanonicalFormCache::find(
+    KeyView key, std::size_t hash) const {
+  const auto &sh = shard(hash);
+  std::shared_lock<std::shared_mutex> lock(sh.mtx);
+  auto [begin, end] = sh.entries.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second.first == key) {
+      ++nhits_;
+      return it->second.second;
+    }
+  }
+  ++nmisses_;
+  return {};
+}
+
+std::shared_ptr<const CanonicalFormCache::Permutation>
+CanonicalFormCache::insert(KeyView key, std::size_t hash, Permutation perm) {
+  auto value = std::make_shared<const Permutation>(std::move(perm));
+  auto &sh = shard(hash);
+  std::unique_lock<std::shared_mutex> lock(sh.mtx);
+  auto [begin, end] = sh.entries.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second.first == key) return it->second.second;
+  }
+  if (sh.entries.size() >= max_size_ / nshards) sh.entries.clear();
+  sh.entries.emplace(
+      hash, std::make_pair(Key{{key.colors.begin(), key.colors.end()},
+                               {key.edges.begin(), key.edges.end()}},
+                           value));
+  return value;
+}
+
+std::size_t CanonicalFormCache::size() const {
+  std::size_t result = 0;
+  for (const auto &sh : shards_) {
+    std::shared_lock<std::shared_mutex> lock(sh.mtx);
+    result += sh.entries.size();
+  }
+  return result;
+}
+
+void CanonicalFormCache::clear() {
+  for (auto &sh : shards_) {
+    std::unique_lock<std::shared_mutex> lock(sh.mtx);
+    sh.entries.clear();
+  }
+  nhits_ = 0;
+  nmisses_ = 0;
+}
+
+}  // namespace sequant
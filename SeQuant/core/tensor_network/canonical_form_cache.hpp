@@ -0,0 +1,146 @@
+#ifndef SEQUANT_CORE_TENSOR_NETWORK_CANONICAL_FORM_CACHE_HPP
+#define SEQUANT_CORE_TENSOR_NETWORK_CANONICAL_FORM_CACHE_HPP
+
+#include <SeQuant/core/container.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+namespace sequant {
+
+// clang-format off
+/// @brief Memoizes the canonical labelings of colored graphs computed by bliss
+
+/// The graph that TensorNetworkV2 hands to bliss does not refer to the labels
+/// of the anonymous (dummy) indices: these only affect the vertex colors via
+/// their spaces. Hence the networks of products that only differ by the dummy
+/// labels produce identical graphs, and the canonical labeling
+/// of such a graph can be reused instead of recomputed.
+///
+/// The cache is keyed by the vertex colors and the edges (in the order of
+/// their insertion into the bliss graph), i.e. by everything that determines
+/// the labeling computed by bliss, hence using the cache does not change the
+/// results. Lookups hash a view of the graph and then verify it by
+/// comparison; the graph is only copied into a Key when a new entry is
+/// inserted. The
+/// entries are distributed over several independently-locked shards to
+/// reduce the contention between threads.
+///
+/// The cache used by TensorNetworkV2 is returned by
+/// CanonicalFormCache::instance(); caching is enabled by default and can be
+/// disabled via
+/// \code
+/// CanonicalFormCache::set_instance(nullptr);
+/// \endcode
+// clang-format on
+class CanonicalFormCache {
+ public:
+  using Color = std::uint32_t;
+  using Edge = std::pair<std::size_t, std::size_t>;
+  using Permutation = container::vector<unsigned int>;
+
+  /// a view of the colored graph, used for lookups
+  struct KeyView {
+    std::span<const Color> colors;
+    std::span<const Edge> edges;
+
+    /// @return the hash value of this key
+    std::size_t hash_value() const;
+  };
+
+  /// the colored graph
+  struct Key {
+    container::vector<Color> colors;
+    container::vector<Edge> edges;
+
+    bool operator==(const Key &other) const = default;
+    bool operator==(const KeyView &other) const {
+      return std::ranges::equal(colors, other.colors) &&
+             std::ranges::equal(edges, other.edges);
+    }
+
+    /// @return the view of this key
+    KeyView view() const { return {colors, edges}; }
+
+    /// @return the hash value of this key
+    std::size_t hash_value() const { return view().hash_value(); }
+  };
+
+  /// the default value of max_size()
+  static constexpr std::size_t default_max_size = 1 << 16;
+
+  /// @param max_size the maximum number of entries; when exceeded, the
+  /// entries of the shard to which the new entry belongs are evicted
+  explicit CanonicalFormCache(std::size_t max_size = default_max_size);
+
+  CanonicalFormCache(const CanonicalFormCache &) = delete;
+  CanonicalFormCache &operator=(const CanonicalFormCache &) = delete;
+
+  /// @return the cache used by TensorNetworkV2; null means caching is
+  /// disabled
+  static std::shared_ptr<CanonicalFormCache> instance();
+
+  /// installs @p cache as the cache used by TensorNetworkV2
+  /// @param cache the cache to use; null disables caching
+  static void set_instance(std::shared_ptr<CanonicalFormCache> cache);
+
+  /// @param key the colored graph
+  /// @param hash the hash value of @p key
+  /// @return the canonical labeling of @p key, or null if not found
+  std::shared_ptr<const Permutation> find(KeyView key, std::size_t hash) const;
+
+  /// associates @p perm with @p key, unless already present
+  /// @param key the colored graph; it is copied only if not yet present
+  /// @param hash the hash value of @p key
+  /// @param perm the canonical labeling of @p key
+  /// @return the labeling associated with @p key
+  std::shared_ptr<const Permutation> insert(KeyView key, std::size_t hash,
+                                            Permutation perm);
+
+  /// @return the maximum number of entries
+  std::size_t max_size() const { return max_size_; }
+
+  /// @return the number of entries in the cache
+  std::size_t size() const;
+
+  /// removes all entries and resets the hit/miss counters
+  void clear();
+
+  /// @return the number of find() calls that found the key
+  std::size_t nhits() const { return nhits_.load(); }
+
+  /// @return the number of find() calls that did not find the key
+  std::size_t nmisses() const { return nmisses_.load(); }
+
+ private:
+  struct Shard {
+    mutable std::shared_mutex mtx;  // guards entries
+    std::unordered_multimap<std::size_t,
+                            std::pair<Key, std::shared_ptr<const Permutation>>>
+        entries;
+  };
+
+  static constexpr std::size_t nshards = 16;
+
+  std::size_t max_size_;
+  std::array<Shard, nshards> shards_;
+  mutable std::atomic<std::size_t> nhits_ = 0;
+  mutable std::atomic<std::size_t> nmisses_ = 0;
+
+  Shard &shard(std::size_t hash) { return shards_[hash % nshards]; }
+  const Shard &shard(std::size_t hash) const {
+    return shards_[hash % nshards];
+  }
+};
+
+}  // namespace sequant
+
+#endif  // SEQUANT_CORE_TENSOR_NETWORK_CANONICAL_FORM_CACHE_HPP
@@ -15,6 +15,7 @@
 #include <SeQuant/core/logger.hpp>
 #include <SeQuant/core/tag.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
+#include <SeQuant/core/tensor_network/canonical_form_cache.hpp>
 #include <SeQuant/core/tensor_network/vertex_painter.hpp>
 #include <SeQuant/core/tensor_network_v2.hpp>
 #include <SeQuant/core/utility/swap.hpp>
@@ -22,15 +23,19 @@
 #include <SeQuant/core/wstring.hpp>
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <variant>
 
+#include <range/v3/algorithm/any_of.hpp>
 #include <range/v3/algorithm/for_each.hpp>
 #include <range/v3/algorithm/none_of.hpp>
 #include <range/v3/functional/identity.hpp>
@@ -40,17 +45,6 @@
 
 namespace sequant {
 
-struct FullLabelIndexLocator {
-  std::wstring_view label;
-  FullLabelIndexLocator(std::wstring_view label) : label(std::move(label)) {}
-
-  bool operator()(const TensorNetworkV2::Edge &edge) const {
-    return edge.idx().full_label() == label;
-  }
-
-  bool operator()(const Index &idx) const { return idx.full_label() == label; }
-};
-
 bool tensors_commute(const AbstractTensor &lhs, const AbstractTensor &rhs) {
   // tensors commute if their colors are different or either one of them
   // is a c-number
@@ -328,6 +322,77 @@ void sort_via_indices(Container &container, const Comparator &cmp) {
   }
 }
 
+/// @return the canonical labeling of the vertices of @p graph computed by
+/// bliss; reuses the labeling found in CanonicalFormCache::instance(), if any
+/// @note the bliss graph of @p graph is only created if it is needed, i.e. if
+///       the labeling is not found in the cache
+std::shared_ptr<const CanonicalFormCache::Permutation> canonical_labeling(
+    TensorNetworkV2::Graph &graph) {
+  auto compute = [&graph]() {
+    if (!graph.bliss_graph) graph.make_bliss_graph();
+    bliss::Stats stats;
+    graph.bliss_graph->set_splitting_heuristic(bliss::Graph::shs_fsm);
+    const unsigned int *perm =
+        graph.bliss_graph->canonical_form(stats, nullptr, nullptr);
+    return CanonicalFormCache::Permutation(
+        perm, perm + graph.bliss_graph->get_nof_vertices());
+  };
+
+  auto cache = CanonicalFormCache::instance();
+  if (!cache)
+    return std::make_shared<const CanonicalFormCache::Permutation>(compute());
+
+  // N.B. the graph is only copied into the cache on a miss
+  const CanonicalFormCache::KeyView key{graph.vertex_colors, graph.edges};
+  const auto hash = key.hash_value();
+  if (auto perm = cache->find(key, hash)) return perm;
+  return cache->insert(key, hash, compute());
+}
+
+/// @return the bliss graph of @p graph with the vertices relabeled by
+/// @p perm, i.e. same as `graph.bliss_graph->permute(perm)`
+std::shared_ptr<bliss::Graph> make_permuted_bliss_graph(
+    const TensorNetworkV2::Graph &graph, const unsigned int *perm) {
+  auto result = std::make_shared<bliss::Graph>(graph.vertex_colors.size());
+  for (std::size_t vertex = 0; vertex != graph.vertex_colors.size(); ++vertex)
+    result->change_color(perm[vertex], graph.vertex_colors[vertex]);
+  for (const auto &[v1, v2] : graph.edges)
+    result->add_edge(perm[v1], perm[v2]);
+  return result;
+}
+
+bool TensorNetworkV2::is_trivially_canonical(
+    const NamedIndexSet &named_indices) const {
+  assert(have_edges_);
+
+  // with 2+ anonymous indices their labeling depends on the canonical graph
+  std::size_t num_anonymous_indices = 0;
+  for (const Edge &current : edges_) {
+    if (named_indices.find(current.idx()) == named_indices.end() &&
+        ++num_anonymous_indices > 1)
+      return false;
+  }
+
+  for (std::size_t i = 0; i < tensors_.size(); ++i) {
+    const AbstractTensor &tensor = *tensors_[i];
+
+    // particle swaps are determined by the canonical graph
+    if (symmetry(tensor) == Symmetry::nonsymm &&
+        std::min(bra_rank(tensor), ket_rank(tensor)) > 1)
+      return false;
+
+    // the order of commuting tensors with distinct labels is determined
+    // by CanonicalTensorCompare alone
+    for (std::size_t j = 0; j < i; ++j) {
+      const AbstractTensor &other = *tensors_[j];
+      if (label(tensor) == label(other) || !tensors_commute(tensor, other))
+        return false;
+    }
+  }
+
+  return true;
+}
+
 void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
   if (Logger::instance().canonicalize) {
     std::wcout << "TensorNetworkV2::canonicalize_graph: input tensors\n";
@@ -349,8 +414,39 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
   // index factory to generate anonymous indices
   IndexFactory idxfac(is_anonymous_index, 1);
 
-  // make the graph
-  Graph graph = create_graph(&named_indices);
+  // Small networks whose canonical form does not depend on the graph
+  // canonization skip making the graph and calling bliss
+  if (is_trivially_canonical(named_indices)) {
+    container::map<Index, Index> idxrepl;
+    for (const Edge &current : edges_) {
+      const Index &idx = current.idx();
+      if (is_anonymous_index(idx))
+        idxrepl.insert(std::make_pair(idx, idxfac.make(idx)));
+    }
+    if (Logger::instance().canonicalize) {
+      for (const auto &idxpair : idxrepl) {
+        std::wcout << "TensorNetworkV2::canonicalize_graph: replacing "
+                   << to_latex(idxpair.first) << " with "
+                   << to_latex(idxpair.second) << " (trivial network)"
+                   << std::endl;
+      }
+    }
+    apply_index_replacements(tensors_, idxrepl, true);
+
+    edges_.clear();
+    have_edges_ = false;
+    return;
+  }
+
+  // make the graph, reusing the workspace of this thread
+  // N.B. vertex labels and the bliss graph are only needed for logging, else
+  // the latter is made by canonical_labeling, if needed
+  thread_local Graph graph;
+  const bool make_labels = Logger::instance().canonicalize_input_graph ||
+                           Logger::instance().canonicalize_dot;
+  fill_graph(graph, &named_indices, /* distinct_named_indices */ true,
+             /* idx_to_vertex */ nullptr, make_labels);
+  if (make_labels) graph.make_bliss_graph();
   // graph.bliss_graph->write_dot(std::wcout, graph.vertex_labels);
 
   if (Logger::instance().canonicalize_input_graph) {
@@ -359,14 +455,12 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
   }
 
   // canonize the graph
-  bliss::Stats stats;
-  graph.bliss_graph->set_splitting_heuristic(bliss::Graph::shs_fsm);
-  const unsigned int *canonize_perm =
-      graph.bliss_graph->canonical_form(stats, nullptr, nullptr);
+  const auto canonize_perm_ptr = canonical_labeling(graph);
+  const unsigned int *canonize_perm = canonize_perm_ptr->data();
 
   if (Logger::instance().canonicalize_dot) {
     std::wcout << "Canonicalization permutation:\n";
-    for (std::size_t i = 0; i < graph.vertex_labels.size(); ++i) {
+    for (std::size_t i = 0; i < graph.vertex_types.size(); ++i) {
       std::wcout << i << " -> " << canonize_perm[i] << "\n";
     }
     std::wcout << "Canonicalized graph:\n";
@@ -378,30 +472,30 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
     delete cgraph;
   }
 
-  container::map<std::size_t, std::size_t> tensor_idx_to_vertex;
+  // tensors and indices (edges_ + pure_proto_indices_) are identified by
+  // their ordinals, these map them to their vertices
+  container::svector<std::size_t> tensor_idx_to_vertex;
   container::map<std::size_t, container::svector<std::size_t, 3>>
       tensor_idx_to_particle_order;
-  container::map<std::size_t, std::size_t> index_idx_to_vertex;
-  std::size_t tensor_idx = 0;
-  std::size_t index_idx = 0;
+  container::vector<std::size_t> index_idx_to_vertex;
+  tensor_idx_to_vertex.reserve(tensors_.size());
+  index_idx_to_vertex.reserve(edges_.size() + pure_proto_indices_.size());
 
   for (std::size_t vertex = 0; vertex < graph.vertex_types.size(); ++vertex) {
     switch (graph.vertex_types[vertex]) {
       case VertexType::Index:
-        index_idx_to_vertex[index_idx] = vertex;
-        index_idx++;
+        index_idx_to_vertex.push_back(vertex);
         break;
       case VertexType::Particle: {
-        assert(tensor_idx > 0);
-        const std::size_t base_tensor_idx = tensor_idx - 1;
+        assert(!tensor_idx_to_vertex.empty());
+        const std::size_t base_tensor_idx = tensor_idx_to_vertex.size() - 1;
         assert(symmetry(*tensors_.at(base_tensor_idx)) == Symmetry::nonsymm);
         tensor_idx_to_particle_order[base_tensor_idx].push_back(
             canonize_perm[vertex]);
         break;
       }
       case VertexType::TensorCore:
-        tensor_idx_to_vertex[tensor_idx] = vertex;
-        tensor_idx++;
+        tensor_idx_to_vertex.push_back(vertex);
         break;
       case VertexType::TensorBra:
       case VertexType::TensorKet:
@@ -427,8 +521,8 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
   // Use this ordering to relabel anonymous indices
   const auto index_sorter = [&index_idx_to_vertex, &canonize_perm](
                                 std::size_t lhs_idx, std::size_t rhs_idx) {
-    const std::size_t lhs_vertex = index_idx_to_vertex.at(lhs_idx);
-    const std::size_t rhs_vertex = index_idx_to_vertex.at(rhs_idx);
+    const std::size_t lhs_vertex = index_idx_to_vertex[lhs_idx];
+    const std::size_t rhs_vertex = index_idx_to_vertex[rhs_idx];
 
     return canonize_perm[lhs_vertex] < canonize_perm[rhs_vertex];
   };
@@ -510,8 +604,8 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
       return false;
     }
 
-    const std::size_t lhs_vertex = tensor_idx_to_vertex.at(lhs_idx);
-    const std::size_t rhs_vertex = tensor_idx_to_vertex.at(rhs_idx);
+    const std::size_t lhs_vertex = tensor_idx_to_vertex[lhs_idx];
+    const std::size_t rhs_vertex = tensor_idx_to_vertex[rhs_idx];
 
     // Commuting tensors are sorted based on their canonical order which is
     // given by the order of the corresponding vertices in the canonical graph
@@ -539,6 +633,48 @@ void TensorNetworkV2::canonicalize_graph(const NamedIndexSet &named_indices) {
 ExprPtr TensorNetworkV2::canonicalize(
     const container::vector<std::wstring> &cardinal_tensor_labels, bool fast,
     const NamedIndexSet *named_indices_ptr) {
+  return canonicalize_impl(cardinal_tensor_labels, fast, named_indices_ptr,
+                           /* canonicalizers */ nullptr);
+}
+
+TensorNetworkV2::IndividualCanonicalizers
+TensorNetworkV2::make_individual_canonicalizers(
+    const NamedIndexSet &named_indices) {
+  return {std::make_shared<TensorBlockCanonicalizer>(named_indices),
+          std::make_shared<DefaultTensorCanonicalizer>(named_indices)};
+}
+
+ExprPtr TensorNetworkV2::canonicalize_batch_element(
+    const ExprPtr &product,
+    const container::vector<std::wstring> &cardinal_tensor_labels, bool fast,
+    const NamedIndexSet &named_indices,
+    const IndividualCanonicalizers &canonicalizers) {
+  if (!product || !product->is<Product>())
+    throw std::invalid_argument(
+        "TensorNetworkV2::canonicalize_batch: expected a Product");
+
+  // N.B. throws if the product contains non-tensors
+  TensorNetworkV2 tn(product->as<Product>().factors());
+  auto byproduct = tn.canonicalize_impl(cardinal_tensor_labels, fast,
+                                        &named_indices, &canonicalizers);
+
+  container::svector<ExprPtr> factors;
+  factors.reserve(tn.tensors().size());
+  for (const auto &tptr : tn.tensors()) {
+    auto exprptr = std::dynamic_pointer_cast<Expr>(tptr);
+    assert(exprptr);
+    factors.emplace_back(std::move(exprptr));
+  }
+  auto scalar = product->as<Product>().scalar();
+  if (byproduct) scalar *= byproduct->as<Constant>().value();
+  return ex<Product>(std::move(scalar), factors.begin(), factors.end(),
+                     Product::Flatten::No);
+}
+
+ExprPtr TensorNetworkV2::canonicalize_impl(
+    const container::vector<std::wstring> &cardinal_tensor_labels, bool fast,
+    const NamedIndexSet *named_indices_ptr,
+    const IndividualCanonicalizers *canonicalizers) {
   if (Logger::instance().canonicalize) {
     std::wcout << "TensorNetworkV2::canonicalize(" << (fast ? "fast" : "slow")
                << "): input tensors\n";
@@ -569,7 +705,10 @@ ExprPtr TensorNetworkV2::canonicalize(
 
   // Ensure each individual tensor is written in the way that its tensor
   // block (== order of index spaces) is canonical
-  ExprPtr byproduct = canonicalize_individual_tensor_blocks(named_indices);
+  ExprPtr byproduct =
+      canonicalizers
+          ? do_individual_canonicalization(*canonicalizers->tensor_blocks)
+          : canonicalize_individual_tensor_blocks(named_indices);
 
   CanonicalTensorCompare<decltype(cardinal_tensor_labels)> tensor_sorter(
       cardinal_tensor_labels, true);
@@ -644,7 +783,9 @@ ExprPtr TensorNetworkV2::canonicalize(
 
   apply_index_replacements(tensors_, idxrepl, true);
 
-  byproduct *= canonicalize_individual_tensors(named_indices);
+  byproduct *= canonicalizers
+                   ? do_individual_canonicalization(*canonicalizers->tensors)
+                   : canonicalize_individual_tensors(named_indices);
 
   // We assume that re-indexing did not change the canonical order of tensors
   assert(std::is_sorted(tensors_.begin(), tensors_.end(), tensor_sorter));
@@ -703,12 +844,16 @@ TensorNetworkV2::canonicalize_slots(
     return named_indices.find(idx) != named_indices.end();
   };
 
-  // make the graph
+  // make the graph, reusing the workspace of this thread
   // only slots (hence, attr) of named indices define their color, so
   // distinct_named_indices = false
-  container::map<Index, std::size_t> idx_to_vertex;
-  Graph graph = create_graph(&named_indices, /*distinct_named_indices*/ false,
-                             &idx_to_vertex);
+  // N.B. vertex labels and the input bliss graph are only needed for logging
+  thread_local Graph graph;
+  const bool make_labels = Logger::instance().canonicalize_input_graph ||
+                           Logger::instance().canonicalize_dot;
+  fill_graph(graph, &named_indices, /*distinct_named_indices*/ false,
+             /* idx_to_vertex */ nullptr, make_labels);
+  if (make_labels) graph.make_bliss_graph();
   // graph.bliss_graph->write_dot(std::wcout, graph.vertex_labels);
 
   if (Logger::instance().canonicalize_input_graph) {
@@ -718,17 +863,14 @@ TensorNetworkV2::canonicalize_slots(
   }
 
   // canonize the graph
-  bliss::Stats stats;
-  graph.bliss_graph->set_splitting_heuristic(bliss::Graph::shs_fsm);
-  const unsigned int *canonize_perm =
-      graph.bliss_graph->canonical_form(stats, nullptr, nullptr);
+  const auto canonize_perm_ptr = canonical_labeling(graph);
+  const unsigned int *canonize_perm = canonize_perm_ptr->data();
 
-  metadata.graph =
-      std::shared_ptr<bliss::Graph>(graph.bliss_graph->permute(canonize_perm));
+  metadata.graph = make_permuted_bliss_graph(graph, canonize_perm);
 
   if (Logger::instance().canonicalize_dot) {
     std::wcout << "Canonicalization permutation:\n";
-    for (std::size_t i = 0; i < graph.vertex_labels.size(); ++i) {
+    for (std::size_t i = 0; i < graph.vertex_types.size(); ++i) {
       std::wcout << i << " -> " << canonize_perm[i] << "\n";
     }
     std::wcout << "Canonicalized graph:\n";
@@ -739,14 +881,12 @@ TensorNetworkV2::canonicalize_slots(
     metadata.graph->write_dot(std::wcout, cvlabels, cvtexlabels);
   }
 
-  // maps index ordinal to vertex ordinal
-  container::map<std::size_t, std::size_t> index_idx_to_vertex;
-  container::map<Index, unsigned int> index_to_canon_vertex;
-  std::size_t index_idx = 0;
+  // maps index ordinal (in edges_ + pure_proto_indices_) to vertex ordinal
+  container::vector<std::size_t> index_idx_to_vertex;
+  index_idx_to_vertex.reserve(edges_.size() + pure_proto_indices_.size());
   for (std::size_t vertex = 0; vertex < graph.vertex_types.size(); ++vertex) {
     if (graph.vertex_types[vertex] == VertexType::Index) {
-      index_idx_to_vertex[index_idx] = vertex;
-      index_idx++;
+      index_idx_to_vertex.push_back(vertex);
     }
   }
   assert(index_idx_to_vertex.size() ==
@@ -835,9 +975,37 @@ TensorNetworkV2::canonicalize_slots(
   //   index bundle is antisymmetric.
   // - Determine this phase change by determining the parity of index
   //   permutations required to arrive at canonical form
+  // - The vertex of each bra/ket slot is looked up via the ordinal of the edge
+  //   attached to it, hence no Index comparisons are needed.
   metadata.phase = 1;
-  container::svector<SwapCountable<std::size_t>> vertices;
+
+  // braket_slot_offsets[t] is the ordinal of the first bra slot of tensor t in
+  // slot_vertices; its ket slots follow its bra slots
+  container::svector<std::size_t> braket_slot_offsets;
+  braket_slot_offsets.reserve(tensors_.size() + 1);
+  braket_slot_offsets.push_back(0);
   for (const AbstractTensor &tensor : tensors_ | ranges::views::indirect) {
+    braket_slot_offsets.push_back(braket_slot_offsets.back() +
+                                  bra_rank(tensor) + ket_rank(tensor));
+  }
+  container::vector<std::size_t> slot_vertices(braket_slot_offsets.back());
+  for (std::size_t edge_idx = 0; edge_idx < edges_.size(); ++edge_idx) {
+    const Edge &edge = edges_[edge_idx];
+    for (std::size_t i = 0; i < edge.vertex_count(); ++i) {
+      const Vertex &vertex =
+          i == 0 ? edge.first_vertex() : edge.second_vertex();
+      if (vertex.getOrigin() == Origin::Aux) continue;
+      const std::size_t tensor_idx = vertex.getTerminalIndex();
+      std::size_t slot = braket_slot_offsets[tensor_idx] + vertex.getIndexSlot();
+      if (vertex.getOrigin() == Origin::Ket)
+        slot += bra_rank(*tensors_[tensor_idx]);
+      slot_vertices[slot] = index_idx_to_vertex[edge_idx];
+    }
+  }
+
+  container::svector<SwapCountable<std::size_t>> vertices;
+  for (std::size_t tensor_idx = 0; tensor_idx < tensors_.size(); ++tensor_idx) {
+    const AbstractTensor &tensor = *tensors_[tensor_idx];
     if (symmetry(tensor) != Symmetry::antisymm) {
       // Only antisymmetric tensors (or rather: their indices) can incur a phase
       // change due to index permutation
@@ -847,13 +1015,13 @@ TensorNetworkV2::canonicalize_slots(
     // Note that the current assumption is that auxiliary indices don't have
     // permutational symmetry, let alone being antisymmetric. Hence, we don't
     // have to include them in the iteration.
-    // Note2: have to create dedicated container to hold ranges as an
-    // initializer list will only return const entries upon iteration and one
-    // can't iterate over const ranges.
-    std::vector index_groups = {tensor._bra(), tensor._ket()};
-    for (auto &indices : index_groups) {
-      using ranges::size;
-      std::size_t n_indices = size(indices);
+    const std::size_t bra_offset = braket_slot_offsets[tensor_idx];
+    const std::size_t ket_offset = bra_offset + bra_rank(tensor);
+    const std::array<std::pair<std::size_t, std::size_t>, 2> slot_groups = {
+        std::make_pair(bra_offset, ket_offset),
+        std::make_pair(ket_offset, braket_slot_offsets[tensor_idx + 1])};
+    for (const auto &[slot_begin, slot_end] : slot_groups) {
+      const std::size_t n_indices = slot_end - slot_begin;
 
       if (n_indices < 2) {
         // If there are < 2 indices, no two indices could have been swapped
@@ -863,9 +1031,8 @@ TensorNetworkV2::canonicalize_slots(
       vertices.clear();
       vertices.reserve(n_indices);
 
-      for (const Index &idx : indices) {
-        const std::size_t vertex = idx_to_vertex.at(idx);
-        vertices.emplace_back(canonize_perm[vertex]);
+      for (std::size_t slot = slot_begin; slot < slot_end; ++slot) {
+        vertices.emplace_back(canonize_perm[slot_vertices[slot]]);
       }
 
       reset_ts_swap_counter<std::size_t>();
@@ -881,9 +1048,43 @@ TensorNetworkV2::canonicalize_slots(
   return metadata;
 }
 
+void TensorNetworkV2::Graph::clear() {
+  bliss_graph.reset();
+  vertex_labels.clear();
+  vertex_texlabels.clear();
+  vertex_colors.clear();
+  vertex_types.clear();
+  edges.clear();
+}
+
+void TensorNetworkV2::Graph::make_bliss_graph() {
+  assert(vertex_colors.size() == vertex_types.size());
+
+  bliss_graph = std::make_unique<bliss::Graph>(vertex_types.size());
+
+  for (const std::pair<std::size_t, std::size_t> &current_edge : edges) {
+    bliss_graph->add_edge(current_edge.first, current_edge.second);
+  }
+
+  for (const auto [vertex, color] : ranges::views::enumerate(vertex_colors)) {
+    bliss_graph->change_color(vertex, color);
+  }
+}
+
 TensorNetworkV2::Graph TensorNetworkV2::create_graph(
     const NamedIndexSet *named_indices_ptr, bool distinct_named_indices,
     container::map<Index, std::size_t> *idx_to_vertex) const {
+  Graph graph;
+  fill_graph(graph, named_indices_ptr, distinct_named_indices, idx_to_vertex,
+             /* make_labels */ true);
+  graph.make_bliss_graph();
+  return graph;
+}
+
+void TensorNetworkV2::fill_graph(
+    Graph &graph, const NamedIndexSet *named_indices_ptr,
+    bool distinct_named_indices,
+    container::map<Index, std::size_t> *idx_to_vertex, bool make_labels) const {
   assert(have_edges_);
 
   // initialize named_indices by default to all external indices
@@ -897,25 +1098,57 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
   constexpr std::size_t num_tensor_components = 5;
 
   // results
-  Graph graph;
+  graph.clear();
   // We know that at the very least all indices and all tensors will yield
   // vertex representations
   std::size_t vertex_count_estimate = edges_.size() +
                                       pure_proto_indices_.size() +
                                       num_tensor_components * tensors_.size();
-  graph.vertex_labels.reserve(vertex_count_estimate);
-  graph.vertex_texlabels.reserve(vertex_count_estimate);
+  if (make_labels) {
+    graph.vertex_labels.reserve(vertex_count_estimate);
+    graph.vertex_texlabels.reserve(vertex_count_estimate);
+  }
   graph.vertex_colors.reserve(vertex_count_estimate);
   graph.vertex_types.reserve(vertex_count_estimate);
 
-  container::map<ProtoBundle, std::size_t> proto_bundles;
-
-  container::map<std::size_t, std::size_t> tensor_vertices;
+  // scratch space, reused by the subsequent calls on this thread
+  thread_local container::map<ProtoBundle, std::size_t> proto_bundles;
+  thread_local container::map<std::size_t, std::size_t> tensor_vertices;
+  thread_local container::map<Index, std::size_t> index_vertices_scratch;
+  proto_bundles.clear();
+  tensor_vertices.clear();
   tensor_vertices.reserve(tensors_.size());
-
-  container::vector<std::pair<std::size_t, std::size_t>> edges;
+  auto &index_vertices =
+      idx_to_vertex ? *idx_to_vertex : index_vertices_scratch;
+  index_vertices.clear();
+  // the Index -> vertex map is only needed to connect the protoindex bundles,
+  // unless requested
+  const bool map_index_vertices =
+      idx_to_vertex || !pure_proto_indices_.empty() ||
+      ranges::any_of(edges_, [](const Edge &edge) {
+        return edge.idx().has_proto_indices();
+      });
+
+  auto &edges = graph.edges;
   edges.reserve(edges_.size() + tensors_.size());
 
+  // appends a vertex, the labels are only made if requested
+  auto add_vertex = [&graph, make_labels](VertexType type,
+                                          Graph::VertexColor color,
+                                          auto &&make_label,
+                                          auto &&make_texlabel) {
+    if (make_labels) {
+      graph.vertex_labels.emplace_back(make_label());
+      graph.vertex_texlabels.emplace_back(make_texlabel());
+    }
+    graph.vertex_types.push_back(type);
+    graph.vertex_colors.push_back(color);
+    return graph.vertex_types.size() - 1;
+  };
+  auto no_texlabel = []() -> std::optional<std::wstring> {
+    return std::nullopt;
+  };
+
   // Add vertices for tensors
   for (std::size_t tensor_idx = 0; tensor_idx < tensors_.size(); ++tensor_idx) {
     assert(tensor_vertices.find(tensor_idx) == tensor_vertices.end());
@@ -924,12 +1157,11 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
 
     // Tensor core
     const auto tlabel = label(tensor);
-    graph.vertex_labels.emplace_back(tlabel);
-    graph.vertex_texlabels.emplace_back(L"$" + utf_to_latex(tlabel) + L"$");
-    graph.vertex_types.emplace_back(VertexType::TensorCore);
-    graph.vertex_colors.push_back(colorizer(tensor));
+    const std::size_t tensor_vertex = add_vertex(
+        VertexType::TensorCore, colorizer(tensor),
+        [&]() { return std::wstring(tlabel); },
+        [&]() { return L"$" + utf_to_latex(tlabel) + L"$"; });
 
-    const std::size_t tensor_vertex = graph.vertex_labels.size() - 1;
     tensor_vertices.insert(std::make_pair(tensor_idx, tensor_vertex));
 
     // Create vertices to group indices
@@ -948,101 +1180,91 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
           braket_symmetry(tensor) == BraKetSymmetry::symm;
 
       for (std::size_t i = 0; i < num_particle_vertices; ++i) {
-        graph.vertex_labels.emplace_back(L"p_" + std::to_wstring(i + 1));
-        graph.vertex_texlabels.emplace_back(std::nullopt);
-        graph.vertex_types.push_back(VertexType::Particle);
         // Particles are indistinguishable -> always use same ID
-        graph.vertex_colors.push_back(colorizer(ParticleGroup{0}));
-        edges.push_back(
-            std::make_pair(tensor_vertex, graph.vertex_labels.size() - 1));
+        const std::size_t vertex = add_vertex(
+            VertexType::Particle, colorizer(ParticleGroup{0}),
+            [i]() { return L"p_" + std::to_wstring(i + 1); }, no_texlabel);
+        edges.push_back(std::make_pair(tensor_vertex, vertex));
       }
 
       for (std::size_t i = 0; i < bra_rank(tensor); ++i) {
         const bool is_unpaired_idx = i >= num_particle_vertices;
         const bool color_idx = is_unpaired_idx || !is_part_symm;
 
-        graph.vertex_labels.emplace_back(L"bra_" + std::to_wstring(i + 1));
-        graph.vertex_texlabels.emplace_back(std::nullopt);
-        graph.vertex_types.push_back(VertexType::TensorBra);
-        graph.vertex_colors.push_back(colorizer(BraGroup{color_idx ? i : 0}));
+        const std::size_t vertex = add_vertex(
+            VertexType::TensorBra, colorizer(BraGroup{color_idx ? i : 0}),
+            [i]() { return L"bra_" + std::to_wstring(i + 1); }, no_texlabel);
 
         const std::size_t connect_vertex =
             tensor_vertex + (is_unpaired_idx ? 0 : (i + 1));
-        edges.push_back(
-            std::make_pair(connect_vertex, graph.vertex_labels.size() - 1));
+        edges.push_back(std::make_pair(connect_vertex, vertex));
       }
 
       for (std::size_t i = 0; i < ket_rank(tensor); ++i) {
         const bool is_unpaired_idx = i >= num_particle_vertices;
         const bool color_idx = is_unpaired_idx || !is_part_symm;
 
-        graph.vertex_labels.emplace_back(L"ket_" + std::to_wstring(i + 1));
-        graph.vertex_texlabels.emplace_back(std::nullopt);
-        graph.vertex_types.push_back(VertexType::TensorKet);
-        if (is_braket_symm) {
-          // Use BraGroup for kets as well as they are supposed to be
-          // indistinguishable
-          graph.vertex_colors.push_back(colorizer(BraGroup{color_idx ? i : 0}));
-        } else {
-          graph.vertex_colors.push_back(colorizer(KetGroup{color_idx ? i : 0}));
-        }
+        // if is_braket_symm, use BraGroup for kets as well as they are
+        // supposed to be indistinguishable
+        const std::size_t vertex = add_vertex(
+            VertexType::TensorKet,
+            is_braket_symm ? colorizer(BraGroup{color_idx ? i : 0})
+                           : colorizer(KetGroup{color_idx ? i : 0}),
+            [i]() { return L"ket_" + std::to_wstring(i + 1); }, no_texlabel);
 
         const std::size_t connect_vertex =
             tensor_vertex + (is_unpaired_idx ? 0 : (i + 1));
-        edges.push_back(
-            std::make_pair(connect_vertex, graph.vertex_labels.size() - 1));
+        edges.push_back(std::make_pair(connect_vertex, vertex));
       }
     } else {
       // Shared set of bra/ket vertices for all indices
-      std::wstring suffix = tensor_sym == Symmetry::symm ? L"_s" : L"_a";
-
-      graph.vertex_labels.push_back(L"bra" + suffix);
-      graph.vertex_texlabels.emplace_back(std::nullopt);
-      graph.vertex_types.push_back(VertexType::TensorBra);
-      graph.vertex_colors.push_back(colorizer(BraGroup{0}));
-      edges.push_back(
-          std::make_pair(tensor_vertex, graph.vertex_labels.size() - 1));
-
-      graph.vertex_labels.push_back(L"ket" + suffix);
-      graph.vertex_texlabels.emplace_back(std::nullopt);
-      graph.vertex_types.push_back(VertexType::TensorKet);
+      const wchar_t *suffix = tensor_sym == Symmetry::symm ? L"_s" : L"_a";
+
+      const std::size_t bra_vertex = add_vertex(
+          VertexType::TensorBra, colorizer(BraGroup{0}),
+          [suffix]() { return L"bra" + std::wstring(suffix); }, no_texlabel);
+      edges.push_back(std::make_pair(tensor_vertex, bra_vertex));
+
       // TODO: figure out how to handle BraKetSymmetry::conjugate
-      if (braket_symmetry(tensor) == BraKetSymmetry::symm) {
-        // Use BraGroup for kets as well as they should be indistinguishable
-        graph.vertex_colors.push_back(colorizer(BraGroup{0}));
-      } else {
-        graph.vertex_colors.push_back(colorizer(KetGroup{0}));
-      }
-      edges.push_back(
-          std::make_pair(tensor_vertex, graph.vertex_labels.size() - 1));
+      // if BraKetSymmetry::symm, use BraGroup for kets as well as they should
+      // be indistinguishable
+      const std::size_t ket_vertex = add_vertex(
+          VertexType::TensorKet,
+          braket_symmetry(tensor) == BraKetSymmetry::symm
+              ? colorizer(BraGroup{0})
+              : colorizer(KetGroup{0}),
+          [suffix]() { return L"ket" + std::wstring(suffix); }, no_texlabel);
+      edges.push_back(std::make_pair(tensor_vertex, ket_vertex));
     }
 
     // TODO: handle aux indices permutation symmetries once they are supported
     // for now, auxiliary indices are considered to always be asymmetric
     for (std::size_t i = 0; i < aux_rank(tensor); ++i) {
-      graph.vertex_labels.emplace_back(L"aux_" + std::to_wstring(i + 1));
-      graph.vertex_texlabels.emplace_back(std::nullopt);
-      graph.vertex_types.push_back(VertexType::TensorAux);
-      graph.vertex_colors.push_back(colorizer(AuxGroup{i}));
-      edges.push_back(
-          std::make_pair(tensor_vertex, graph.vertex_labels.size() - 1));
+      const std::size_t vertex = add_vertex(
+          VertexType::TensorAux, colorizer(AuxGroup{i}),
+          [i]() { return L"aux_" + std::to_wstring(i + 1); }, no_texlabel);
+      edges.push_back(std::make_pair(tensor_vertex, vertex));
     }
   }
 
   // Now add all indices (edges_ + pure_proto_indices_) to the graph
-  container::map<Index, std::size_t> index_vertices;
+  auto index_label = [](const Index &index) {
+    return [&index]() { return std::wstring(index.full_label()); };
+  };
+  auto index_texlabel = [](const Index &index) {
+    return [&index]() -> std::optional<std::wstring> {
+      using namespace std::string_literals;
+      return L"$"s + index.to_latex() + L"$";
+    };
+  };
 
   for (const Edge &current_edge : edges_) {
     const Index &index = current_edge.idx();
-    graph.vertex_labels.push_back(std::wstring(index.full_label()));
-    using namespace std::string_literals;
-    graph.vertex_texlabels.emplace_back(L"$"s + index.to_latex() + L"$");
-    graph.vertex_types.push_back(VertexType::Index);
-    graph.vertex_colors.push_back(colorizer(index));
-
-    const std::size_t index_vertex = graph.vertex_labels.size() - 1;
+    const std::size_t index_vertex =
+        add_vertex(VertexType::Index, colorizer(index), index_label(index),
+                   index_texlabel(index));
 
-    index_vertices[index] = index_vertex;
+    if (map_index_vertices) index_vertices[index] = index_vertex;
 
     // Handle proto indices
     if (index.has_proto_indices()) {
@@ -1056,27 +1278,26 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
       } else {
         using namespace std::literals;
         // Create a new vertex for this bundle of proto indices
-        std::wstring spbundle_label =
-            L"<" +
-            (ranges::views::transform(
-                 index.proto_indices(),
-                 [](const Index &idx) { return idx.full_label(); }) |
-             ranges::views::join(L","sv) | ranges::to<std::wstring>()) +
-            L">";
-        std::wstring spbundle_texlabel =
-            L"$\\langle" +
-            (ranges::views::transform(
-                 index.proto_indices(),
-                 [](const Index &idx) { return idx.to_latex(); }) |
-             ranges::views::join(L","sv) | ranges::to<std::wstring>()) +
-            L"\\rangle$";
-
-        graph.vertex_labels.push_back(std::move(spbundle_label));
-        graph.vertex_texlabels.push_back(std::move(spbundle_texlabel));
-        graph.vertex_types.push_back(VertexType::SPBundle);
-        graph.vertex_colors.push_back(colorizer(index.proto_indices()));
-
-        proto_vertex = graph.vertex_labels.size() - 1;
+        auto spbundle_label = [&index]() {
+          return L"<" +
+                 (ranges::views::transform(
+                      index.proto_indices(),
+                      [](const Index &idx) { return idx.full_label(); }) |
+                  ranges::views::join(L","sv) | ranges::to<std::wstring>()) +
+                 L">";
+        };
+        auto spbundle_texlabel = [&index]() -> std::optional<std::wstring> {
+          return L"$\\langle" +
+                 (ranges::views::transform(
+                      index.proto_indices(),
+                      [](const Index &idx) { return idx.to_latex(); }) |
+                  ranges::views::join(L","sv) | ranges::to<std::wstring>()) +
+                 L"\\rangle$";
+        };
+
+        proto_vertex = add_vertex(VertexType::SPBundle,
+                                  colorizer(index.proto_indices()),
+                                  spbundle_label, spbundle_texlabel);
         proto_bundles.insert(
             std::make_pair(index.proto_indices(), proto_vertex));
       }
@@ -1128,22 +1349,18 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
 
       const std::size_t tensor_component_vertex = tensor_vertex + offset;
 
-      assert(tensor_component_vertex < graph.vertex_labels.size());
+      assert(tensor_component_vertex < graph.vertex_types.size());
       edges.push_back(std::make_pair(index_vertex, tensor_component_vertex));
     }
   }
 
   // also create vertices for pure proto indices
   for (const auto &index : pure_proto_indices_) {
-    graph.vertex_labels.push_back(std::wstring(index.full_label()));
-    using namespace std::string_literals;
-    graph.vertex_texlabels.push_back(L"$"s + index.to_latex() + L"$");
-    graph.vertex_types.push_back(VertexType::Index);
-    graph.vertex_colors.push_back(colorizer(index));
+    const std::size_t index_vertex =
+        add_vertex(VertexType::Index, colorizer(index), index_label(index),
+                   index_texlabel(index));
 
-    const std::size_t index_vertex = graph.vertex_labels.size() - 1;
-
-    index_vertices[index] = index_vertex;
+    if (map_index_vertices) index_vertices[index] = index_vertex;
   }
 
   // Add edges between proto index bundle vertices and all vertices of the
@@ -1162,28 +1379,11 @@ TensorNetworkV2::Graph TensorNetworkV2::create_graph(
     }
   }
 
-  assert(graph.vertex_labels.size() == graph.vertex_texlabels.size());
-  assert(graph.vertex_labels.size() == graph.vertex_colors.size());
-  assert(graph.vertex_labels.size() == graph.vertex_types.size());
-
-  // Create the actual BLISS graph object
-  graph.bliss_graph =
-      std::make_unique<bliss::Graph>(graph.vertex_labels.size());
-
-  for (const std::pair<std::size_t, std::size_t> &current_edge : edges) {
-    graph.bliss_graph->add_edge(current_edge.first, current_edge.second);
-  }
-
-  for (const auto [vertex, color] :
-       ranges::views::enumerate(graph.vertex_colors)) {
-    graph.bliss_graph->change_color(vertex, color);
-  }
-
-  if (idx_to_vertex) {
-    *idx_to_vertex = std::move(index_vertices);
-  }
-
-  return graph;
+  assert(!make_labels ||
+         graph.vertex_labels.size() == graph.vertex_types.size());
+  assert(!make_labels ||
+         graph.vertex_texlabels.size() == graph.vertex_types.size());
+  assert(graph.vertex_colors.size() == graph.vertex_types.size());
 }
 
 void TensorNetworkV2::init_edges() {
@@ -1191,6 +1391,13 @@ void TensorNetworkV2::init_edges() {
   ext_indices_.clear();
   pure_proto_indices_.clear();
 
+  // maps full index labels to the ordinals of their edges in edges_
+  // N.B. the keys view the labels of the indices of tensors_, hence are only
+  // valid during this call; the map is reused by the subsequent calls on this
+  // thread
+  thread_local std::unordered_map<std::wstring_view, std::size_t> edge_ords;
+  edge_ords.clear();
+
   auto idx_insert = [this](const Index &idx, Vertex vertex) {
     if (Logger::instance().tensor_network) {
       std::wcout << "TensorNetworkV2::init_edges: idx=" << to_latex(idx)
@@ -1201,12 +1408,12 @@ void TensorNetworkV2::init_edges() {
                  << std::endl;
     }
 
-    auto it = std::find_if(edges_.begin(), edges_.end(),
-                           FullLabelIndexLocator(idx.full_label()));
-    if (it == edges_.end()) {
+    const auto [it, inserted] =
+        edge_ords.try_emplace(idx.full_label(), edges_.size());
+    if (inserted) {
       edges_.emplace_back(std::move(vertex), idx);
     } else {
-      it->connect_to(std::move(vertex));
+      edges_[it->second].connect_to(std::move(vertex));
     }
   };
 
@@ -9,6 +9,7 @@
 #include <SeQuant/core/container.hpp>
 #include <SeQuant/core/expr.hpp>
 #include <SeQuant/core/index.hpp>
+#include <SeQuant/core/runtime.hpp>
 #include <SeQuant/core/tensor_network/canonicals.hpp>
 #include <SeQuant/core/tensor_network/slot.hpp>
 #include <SeQuant/core/tensor_network/vertex.hpp>
@@ -184,9 +185,17 @@ class TensorNetworkV2 {
     std::vector<std::optional<std::wstring>> vertex_texlabels;
     std::vector<VertexColor> vertex_colors;
     std::vector<VertexType> vertex_types;
+    /// the edges of bliss_graph, in the order of their insertion
+    container::vector<std::pair<std::size_t, std::size_t>> edges;
 
     Graph() = default;
 
+    /// removes the vertices and edges, but keeps the allocated memory
+    void clear();
+
+    /// (re)creates bliss_graph from vertex_colors and edges
+    void make_bliss_graph();
+
     std::size_t vertex_to_index_idx(std::size_t vertex) const;
     std::size_t vertex_to_tensor_idx(std::size_t vertex) const;
   };
@@ -244,6 +253,37 @@ class TensorNetworkV2 {
       const container::vector<std::wstring> &cardinal_tensor_labels = {},
       bool fast = true, const NamedIndexSet *named_indices = nullptr);
 
+  /// Canonicalizes a batch of products of tensors that share the named
+  /// indices, e.g. the terms of one residual.
+  ///
+  /// Each product is replaced by the Product of the tensors of its canonical
+  /// network, scaled by the byproduct of canonicalization, i.e. the result is
+  /// the same as that of calling
+  /// `canonicalize(cardinal_tensor_labels, fast, &named_indices)` on the
+  /// network of each product. The per-call setup (the tensor canonicalizers
+  /// for @p named_indices ) is done once for the whole batch, and the products
+  /// are canonicalized in parallel (see sequant::for_each).
+  /// @param products a range of ExprPtr, each pointing to a Product whose
+  /// factors are AbstractTensor objects
+  /// @param cardinal_tensor_labels see canonicalize()
+  /// @param fast see canonicalize()
+  /// @param named_indices the named indices shared by all products
+  /// @throw std::invalid_argument if any element of @p products is not a
+  /// Product of tensors
+  template <typename ExprPtrRange>
+  static void canonicalize_batch(
+      ExprPtrRange &products,
+      const container::vector<std::wstring> &cardinal_tensor_labels,
+      bool fast, const NamedIndexSet &named_indices) {
+    static_assert(
+        std::is_base_of_v<ExprPtr, ranges::range_value_t<ExprPtrRange>>);
+    const auto canonicalizers = make_individual_canonicalizers(named_indices);
+    sequant::for_each(products, [&](ExprPtr &product) {
+      product = canonicalize_batch_element(product, cardinal_tensor_labels,
+                                           fast, named_indices, canonicalizers);
+    });
+  }
+
   /// metadata produced by canonicalize_slots()
   struct SlotCanonicalizationMetadata {
     /// list of named indices
@@ -368,6 +408,15 @@ class TensorNetworkV2 {
       container::map<Index, std::size_t> *idx_to_vertex = nullptr) const;
 
  private:
+  /// same as create_graph(), but refills @p graph, reusing its memory,
+  /// instead of making a new Graph
+  /// @param make_labels if false, will not make the vertex (tex)labels
+  /// @note does not create the bliss graph, use Graph::make_bliss_graph()
+  void fill_graph(Graph &graph, const NamedIndexSet *named_indices,
+                  bool distinct_named_indices,
+                  container::map<Index, std::size_t> *idx_to_vertex,
+                  bool make_labels) const;
+
   /// list of tensors
   /// - before canonicalize(): input
   /// - after canonicalize(): canonical
@@ -398,6 +447,14 @@ class TensorNetworkV2 {
   /// remains undefined.
   void canonicalize_graph(const NamedIndexSet &named_indices);
 
+  /// @return true if canonicalize_graph() can skip the graph canonization
+  /// because its effect does not depend on the canonical graph, i.e. if the
+  /// network has at most one anonymous index, no nonsymmetric tensor with
+  /// multiple particles, and its tensors are pairwise commuting and have
+  /// distinct labels (so that canonicalize() orders them uniquely)
+  /// @param named_indices the named indices
+  bool is_trivially_canonical(const NamedIndexSet &named_indices) const;
+
   /// Canonicalizes every individual tensor for itself, taking into account only
   /// tensor blocks
   /// @returns The byproduct of the canonicalizations
@@ -411,6 +468,32 @@ class TensorNetworkV2 {
   ExprPtr do_individual_canonicalization(
       const TensorCanonicalizer &canonicalizer);
 
+  /// canonicalizers used by canonicalize_individual_tensor_blocks() and
+  /// canonicalize_individual_tensors() for a particular set of named indices
+  struct IndividualCanonicalizers {
+    std::shared_ptr<const TensorCanonicalizer> tensor_blocks;
+    std::shared_ptr<const TensorCanonicalizer> tensors;
+  };
+
+  static IndividualCanonicalizers make_individual_canonicalizers(
+      const NamedIndexSet &named_indices);
+
+  /// implements canonicalize()
+  /// @param canonicalizers if not null, the canonicalizers for
+  /// the named indices, else they will be made
+  ExprPtr canonicalize_impl(
+      const container::vector<std::wstring> &cardinal_tensor_labels, bool fast,
+      const NamedIndexSet *named_indices,
+      const IndividualCanonicalizers *canonicalizers);
+
+  /// canonicalizes a single element of canonicalize_batch()
+  /// @return the canonicalized @p product
+  static ExprPtr canonicalize_batch_element(
+      const ExprPtr &product,
+      const container::vector<std::wstring> &cardinal_tensor_labels,
+      bool fast, const NamedIndexSet &named_indices,
+      const IndividualCanonicalizers &canonicalizers);
+
   void add_expr(const Expr &expr) {
     ExprPtr clone = expr.clone();
 
@@ -0,0 +1,77 @@
+#ifndef SEQUANT_CORE_UTILITY_ATOMIC_SHARED_PTR_HPP
+#define SEQUANT_CORE_UTILITY_ATOMIC_SHARED_PTR_HPP
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace sequant {
+
+/// @brief a std::shared_ptr that can be loaded and stored concurrently
+
+/// Holds the pointer as std::atomic<std::shared_ptr<T>> where available, else
+/// uses the std::atomic_load / std::atomic_store overloads for std::shared_ptr.
+/// Useful for publishing immutable snapshots of rarely-modified data that is
+/// read often: readers load (and thus pin) the current snapshot without
+/// locking, writers replace it.
+/// @tparam T the pointee type
+template <typename T>
+class AtomicSharedPtr {
+ public:
+  AtomicSharedPtr() noexcept = default;
+
+  /// @param ptr the initial value
+  explicit AtomicSharedPtr(std::shared_ptr<T> ptr) noexcept
+      : ptr_(std::move(ptr)) {}
+
+  AtomicSharedPtr(const AtomicSharedPtr &) = delete;
+  AtomicSharedPtr &operator=(const AtomicSharedPtr &) = delete;
+
+  /// @return the current value
+  std::shared_ptr<T> load() const noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+    return ptr_.load();
+#else
+    return std::atomic_load(&ptr_);
+#endif
+  }
+
+  /// @param ptr the new value
+  void store(std::shared_ptr<T> ptr) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+    ptr_.store(std::move(ptr));
+#else
+    std::atomic_store(&ptr_, std::move(ptr));
+#endif
+  }
+
+  /// replaces the value with @p desired if it is @p expected
+  /// @param[in,out] expected the expected value; set to the current value on
+  /// failure
+  /// @param desired the new value
+  /// @return true if the value was replaced
+  bool compare_exchange_strong(std::shared_ptr<T> &expected,
+                               std::shared_ptr<T> desired) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+    return ptr_.compare_exchange_strong(expected, std::move(desired));
+#else
+    return std::atomic_compare_exchange_strong(&ptr_, &expected,
+                                               std::move(desired));
+#endif
+  }
+
+ private:
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+  std::atomic<std::shared_ptr<T>> ptr_;
+#else
+  std::shared_ptr<T> ptr_;
+#endif
+};
+
+}  // namespace sequant
+
+#endif  // SEQUANT_CORE_UTILITY_ATOMIC_SHARED_PTR_HPP
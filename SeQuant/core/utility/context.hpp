@@ -1,6 +1,8 @@
 #ifndef SEQUANT_CORE_UTILITY_CONTEXT_HPP
 #define SEQUANT_CORE_UTILITY_CONTEXT_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <optional>
 
 /// \name reusable components for manipulation of global contexts
@@ -15,6 +17,14 @@ inline Ctx& implicit_context_instance() {
   return instance_;
 }
 
+/// @return the counter of modifications of the implicit context of type
+/// @p Ctx ; can be used to invalidate data that depends on the context
+template <typename Ctx>
+inline std::atomic<std::size_t>& implicit_context_epoch() {
+  static std::atomic<std::size_t> epoch_ = 0;
+  return epoch_;
+}
+
 template <typename Ctx>
 const Ctx& get_implicit_context() {
   return implicit_context_instance<Ctx>();
@@ -23,11 +33,13 @@ const Ctx& get_implicit_context() {
 template <typename Ctx>
 void set_implicit_context(const Ctx& ctx) {
   implicit_context_instance<Ctx>() = ctx;
+  ++implicit_context_epoch<Ctx>();
 }
 
 template <typename Ctx>
 void reset_implicit_context() {
   implicit_context_instance<Ctx>() = Ctx{};
+  ++implicit_context_epoch<Ctx>();
 }
 
 /// used to auto-reset implicit context after leaving scope
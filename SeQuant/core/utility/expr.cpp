@@ -301,19 +301,20 @@ ExprPtr transform_expr(const ExprPtr &expr,
 
   auto transform_product = [&transform_tensor,
                             &scaling_factor](const Product &product) {
-    auto result = std::make_shared<Product>();
-    result->scale(product.scalar());
+    auto result = ex<Product>();
+    auto &result_product = result->as<Product>();
+    result_product.scale(product.scalar());
     for (auto &&term : product) {
       if (term->is<Tensor>()) {
         auto tensor = term->as<Tensor>();
-        result->append(1, transform_tensor(tensor));
+        result_product.append(1, transform_tensor(tensor));
       } else if (term->is<Variable>() || term->is<Constant>()) {
-        result->append(1, term->clone());
+        result_product.append(1, term->clone());
       } else {
         throw std::runtime_error("Invalid Expr type in transform_product");
       }
     }
-    result->scale(scaling_factor);
+    result_product.scale(scaling_factor);
     return result;
   };
 
@@ -325,9 +326,10 @@ ExprPtr transform_expr(const ExprPtr &expr,
     auto result = transform_product(expr->as<Product>());
     return result;
   } else if (expr->is<Sum>()) {
-    auto result = std::make_shared<Sum>();
+    auto result = ex<Sum>();
     for (auto &term : *expr) {
-      result->append(transform_expr(term, index_replacements, scaling_factor));
+      result->as<Sum>().append(
+          transform_expr(term, index_replacements, scaling_factor));
     }
     return result;
   } else {
@@ -0,0 +1,77 @@
+#include <SeQuant/core/hash.hpp>
+#include <SeQuant/core/utility/interned_string.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace sequant::detail {
+
+const InternedWString::Entry *InternedWString::intern(std::wstring_view str) {
+  // N.B. keys view the strings owned by the (address-stable) entries
+  static std::unordered_map<std::wstring_view, std::unique_ptr<const Entry>>
+      table;
+  static std::shared_mutex mtx;
+
+  {  // strings are mostly interned already, so try the lookup first
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto it = table.find(str);
+    if (it != table.end()) return it->second.get();
+  }
+
+  // N.B. make the entry before locking since it may intern the base of str
+  auto entry = std::make_unique<const Entry>(make_entry(std::wstring(str)));
+  std::unique_lock<std::shared_mutex> lock(mtx);
+  auto it = table.find(str);
+  if (it == table.end()) {
+    const std::wstring_view key = entry->str;
+    it = table.emplace(key, std::move(entry)).first;
+  }
+  return it->second.get();
+}
+
+InternedWString::Entry InternedWString::make_entry(std::wstring str) {
+  const auto hash = hash::value(std::wstring_view{str});
+  Entry result{std::move(str), hash};
+
+  // split into base and ordinal, if the string has the form base_ordinal
+  const std::wstring_view view = result.str;
+  const auto underscore_position = view.rfind(L'_');
+  if (underscore_position != std::wstring_view::npos &&
+      underscore_position != 0) {
+    const auto ordinal_str = view.substr(underscore_position + 1);
+    // N.B. only canonical representations of ordinals that fit in 64 bits
+    // are accepted, so that the split is unique
+    const bool canonical =
+        !ordinal_str.empty() && ordinal_str.size() <= 18 &&
+        (ordinal_str.size() == 1 || ordinal_str.front() != L'0') &&
+        std::all_of(ordinal_str.begin(), ordinal_str.end(),
+                    [](wchar_t c) { return c >= L'0' && c <= L'9'; });
+    if (canonical) {
+      std::uint64_t ordinal = 0;
+      for (auto c : ordinal_str) ordinal = 10 * ordinal + (c - L'0');
+      result.base = intern(view.substr(0, underscore_position));
+      result.ordinal = ordinal;
+    }
+  }
+  return result;
+}
+
+InternedWString::Entry InternedWString::make_entry(const InternedWString &base,
+                                                   std::uint64_t ordinal) {
+  std::wstring str = base.str() + L'_' + std::to_wstring(ordinal);
+  // N.B. split exactly as make_entry(std::wstring) would
+  if (!base.entry_ || base.owner_ || ordinal >= 1'000'000'000'000'000'000ull)
+    return make_entry(std::move(str));
+  const auto hash = hash::value(std::wstring_view{str});
+  return Entry{std::move(str), hash, base.entry_, ordinal};
+}
+
+const InternedWString::Entry &InternedWString::empty() {
+  static const Entry entry{std::wstring{}, hash::value(std::wstring_view{})};
+  return entry;
+}
+
+}  // namespace sequant::detail
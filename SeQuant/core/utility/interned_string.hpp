@@ -0,0 +1,144 @@
+#ifndef SEQUANT_CORE_UTILITY_INTERNED_STRING_HPP
+#define SEQUANT_CORE_UTILITY_INTERNED_STRING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace sequant::detail {
+
+/// @brief a wide string interned in the global symbol table
+
+/// Each distinct string is stored in the table once and is never deallocated,
+/// hence copying, equality comparison and hashing of interned strings are
+/// O(1). Used for the labels of Index and the base keys of IndexSpace.
+///
+/// Since the table only grows, strings that are generated in unbounded
+/// numbers (e.g. the labels of temporary indices) should not be interned;
+/// transient() makes an object that owns its string instead. Such objects
+/// compare equal to the interned copies of their strings.
+///
+/// Strings of the form `base_ordinal`, where `ordinal` is a nonnegative
+/// decimal integer without leading zeros (e.g. Index labels like `i_12`), are
+/// also represented by the pair of the interned `base` and the integer
+/// `ordinal` (see base_id() and ordinal()); hence comparing such strings is
+/// O(1) even if they are transient.
+/// @note the symbol table is thread-safe; lookups take a shared lock, hence
+/// interning is meant for strings that are constructed rarely and copied
+/// often
+class InternedWString {
+ public:
+  /// constructs an empty string
+  InternedWString() = default;
+
+  /// @param str the string to intern
+  explicit InternedWString(std::wstring_view str)
+      : entry_(str.empty() ? nullptr : intern(str)) {}
+
+  /// @param str a string
+  /// @return an object that owns @p str without entering it into the symbol
+  /// table; its storage is released with its last copy
+  static InternedWString transient(std::wstring str) {
+    InternedWString result;
+    if (!str.empty()) {
+      auto entry = std::make_shared<const Entry>(make_entry(std::move(str)));
+      result.entry_ = entry.get();
+      result.owner_ = std::move(entry);
+    }
+    return result;
+  }
+
+  /// @param base an interned string
+  /// @param ordinal an integer
+  /// @return an object that owns `base_ordinal` (see transient(std::wstring))
+  /// @note unlike transient(std::wstring) this does not parse the string
+  static InternedWString transient(const InternedWString &base,
+                                   std::uint64_t ordinal) {
+    InternedWString result;
+    auto entry = std::make_shared<const Entry>(make_entry(base, ordinal));
+    result.entry_ = entry.get();
+    result.owner_ = std::move(entry);
+    return result;
+  }
+
+  /// @return the string
+  const std::wstring &str() const {
+    return entry_ ? entry_->str : empty().str;
+  }
+
+  /// @return the hash value of the string, equal to `hash::value(str())`
+  /// with `str()` viewed as `std::wstring_view`
+  std::size_t hash_value() const {
+    return entry_ ? entry_->hash : empty().hash;
+  }
+
+  /// @return true if this is a transient string, i.e. it is not in the
+  /// symbol table
+  bool is_transient() const noexcept { return owner_ != nullptr; }
+
+  /// @return the identity of the interned `base` if this has the form
+  /// `base_ordinal` , else null; strings with equal bases have equal
+  /// base identities
+  const void *base_id() const noexcept {
+    return entry_ ? entry_->base : nullptr;
+  }
+
+  /// @return the `ordinal` if this has the form `base_ordinal` (i.e. if
+  /// base_id() is not null), else 0
+  std::uint64_t ordinal() const noexcept {
+    return entry_ ? entry_->ordinal : 0;
+  }
+
+  /// @return true if @p s1 and @p s2 are the same string
+  /// @note this is O(1) unless both strings are transient and do not have the
+  /// form `base_ordinal`
+  friend bool operator==(const InternedWString &s1,
+                         const InternedWString &s2) noexcept {
+    if (s1.entry_ == s2.entry_) return true;
+    // distinct interned strings differ, and so does the empty string from
+    // the others
+    if ((!s1.owner_ && !s2.owner_) || !s1.entry_ || !s2.entry_) return false;
+    // N.B. equal strings are split into base and ordinal identically
+    if (s1.entry_->base || s2.entry_->base)
+      return s1.entry_->base == s2.entry_->base &&
+             s1.entry_->ordinal == s2.entry_->ordinal;
+    return s1.hash_value() == s2.hash_value() && s1.str() == s2.str();
+  }
+
+  /// @return true if @p s1 and @p s2 are different strings
+  friend bool operator!=(const InternedWString &s1,
+                         const InternedWString &s2) noexcept {
+    return !(s1 == s2);
+  }
+
+ private:
+  struct Entry {
+    std::wstring str;
+    std::size_t hash;
+    /// the interned base of str if it has the form `base_ordinal`, else null
+    const Entry *base = nullptr;
+    std::uint64_t ordinal = 0;
+  };
+  /// null for the empty string
+  const Entry *entry_ = nullptr;
+  /// owns *entry_ if this is a transient string, else null
+  std::shared_ptr<const Entry> owner_;
+
+  /// @return the entry of the symbol table for @p str , inserted if missing
+  static const Entry *intern(std::wstring_view str);
+
+  /// @return the entry for @p str , not in the symbol table
+  static Entry make_entry(std::wstring str);
+
+  /// @return the entry for `base_ordinal` , not in the symbol table
+  static Entry make_entry(const InternedWString &base, std::uint64_t ordinal);
+
+  /// @return the entry representing the empty string
+  static const Entry &empty();
+};
+
+}  // namespace sequant::detail
+
+#endif  // SEQUANT_CORE_UTILITY_INTERNED_STRING_HPP
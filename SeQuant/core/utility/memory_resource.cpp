@@ -0,0 +1,28 @@
+#include <SeQuant/core/utility/memory_resource.hpp>
+
+namespace sequant {
+
+namespace {
+/// the resource used by ex() on the calling thread, null if none
+thread_local std::shared_ptr<std::pmr::memory_resource> this_thread_resource;
+}  // namespace
+
+const std::shared_ptr<std::pmr::memory_resource> &
+expr_memory_resource() noexcept {
+  return this_thread_resource;
+}
+
+std::shared_ptr<std::pmr::memory_resource> make_expr_memory_pool() {
+  return std::make_shared<std::pmr::synchronized_pool_resource>();
+}
+
+ScopedExprMemoryResource::ScopedExprMemoryResource(
+    std::shared_ptr<std::pmr::memory_resource> resource)
+    : resource_(std::move(resource)),
+      previous_resource_(std::exchange(this_thread_resource, resource_)) {}
+
+ScopedExprMemoryResource::~ScopedExprMemoryResource() {
+  this_thread_resource = std::move(previous_resource_);
+}
+
+}  // namespace sequant
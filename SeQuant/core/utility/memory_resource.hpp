@@ -0,0 +1,118 @@
+#ifndef SEQUANT_CORE_UTILITY_MEMORY_RESOURCE_HPP
+#define SEQUANT_CORE_UTILITY_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace sequant {
+
+/// @brief an allocator that shares the ownership of its memory resource
+
+/// Unlike std::pmr::polymorphic_allocator this allocator keeps its resource
+/// alive, hence objects allocated via std::allocate_shared can safely
+/// outlive every other reference to the resource; the resource is destroyed
+/// once the last such object is deallocated.
+/// @tparam T the value type
+template <typename T>
+class SharedResourceAllocator {
+ public:
+  using value_type = T;
+
+  /// @param resource the memory resource, must not be null
+  explicit SharedResourceAllocator(
+      std::shared_ptr<std::pmr::memory_resource> resource) noexcept
+      : resource_(std::move(resource)) {}
+
+  template <typename U>
+  SharedResourceAllocator(const SharedResourceAllocator<U> &other) noexcept
+      : resource_(other.resource()) {}
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *ptr, std::size_t n) noexcept {
+    resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+  }
+
+  /// @return the memory resource
+  const std::shared_ptr<std::pmr::memory_resource> &resource() const noexcept {
+    return resource_;
+  }
+
+  template <typename U>
+  friend bool operator==(const SharedResourceAllocator &a,
+                         const SharedResourceAllocator<U> &b) noexcept {
+    return a.resource() == b.resource() || *a.resource() == *b.resource();
+  }
+
+ private:
+  std::shared_ptr<std::pmr::memory_resource> resource_;
+};
+
+/// @return the memory resource from which ex() allocates Expr objects on the
+/// calling thread; null (the default) means the global heap is used
+/// @sa ScopedExprMemoryResource
+const std::shared_ptr<std::pmr::memory_resource> &
+expr_memory_resource() noexcept;
+
+/// @return a new pool resource suitable for use with ScopedExprMemoryResource
+/// @note a pool only returns its memory to the upstream resource when it is
+/// destroyed, i.e. when the last Expr allocated from it is gone; hence a
+/// single long-lived Expr keeps all of the pool's memory allocated
+std::shared_ptr<std::pmr::memory_resource> make_expr_memory_pool();
+
+/// @brief installs a memory resource for the Expr objects created by ex() on
+/// the calling thread for the lifetime of this object
+
+/// Derivations create and destroy very many small, short-lived Expr objects;
+/// allocating them from a pool (e.g. for the duration of a Wick task or a
+/// simplify call) avoids most calls to the global allocator and the heap
+/// fragmentation that comes with them. Scopes can be nested; the destructor
+/// reinstates the previously installed resource.
+/// @note the resource is per-thread, but the tasks submitted by the calling
+/// thread to the thread pool (e.g. by sequant::for_each) are executed with
+/// it installed
+/// @note objects allocated from the resource keep it alive, hence they can
+/// outlive the scope; since they can also be destroyed by any thread the
+/// resource must be thread-safe unless the objects are known to not escape
+/// the calling thread
+/// @warning the results that outlive the scope keep the entire resource
+/// allocated (see make_expr_memory_pool()); results to be kept for long
+/// should be cloned (see Expr::clone()) after leaving the scope
+class ScopedExprMemoryResource {
+ public:
+  /// @param resource the resource to install, null reinstates the global
+  /// heap; the default is a new (thread-safe) pool,
+  /// see make_expr_memory_pool()
+  explicit ScopedExprMemoryResource(
+      std::shared_ptr<std::pmr::memory_resource> resource =
+          make_expr_memory_pool());
+
+  ScopedExprMemoryResource(const ScopedExprMemoryResource &) = delete;
+  ScopedExprMemoryResource(ScopedExprMemoryResource &&) = delete;
+  ScopedExprMemoryResource &operator=(const ScopedExprMemoryResource &) =
+      delete;
+  ScopedExprMemoryResource &operator=(ScopedExprMemoryResource &&) = delete;
+
+  ~ScopedExprMemoryResource();
+
+  /// @return the installed resource
+  const std::shared_ptr<std::pmr::memory_resource> &resource() const noexcept {
+    return resource_;
+  }
+
+ private:
+  std::shared_ptr<std::pmr::memory_resource> resource_;
+  std::shared_ptr<std::pmr::memory_resource> previous_resource_;
+};
+
+}  // namespace sequant
+
+#endif  // SEQUANT_CORE_UTILITY_MEMORY_RESOURCE_HPP
@@ -0,0 +1,177 @@
+#include <SeQuant/core/runtime.hpp>
+#include <SeQuant/core/utility/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace sequant::detail {
+
+namespace {
+/// the pool whose worker is the calling thread, nullptr if not a worker
+thread_local ThreadPool* this_thread_pool = nullptr;
+/// the ordinal of the calling thread among its pool's workers
+thread_local std::size_t this_thread_worker_id = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t nworkers) {
+  queues_.reserve(nworkers);
+  for (std::size_t w = 0; w != nworkers; ++w)
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  workers_.reserve(nworkers);
+  for (std::size_t w = 0; w != nworkers; ++w)
+    workers_.emplace_back([this, w]() { worker_loop(w); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::scoped_lock<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+namespace {
+
+#if defined(__cpp_lib_atomic_shared_ptr) && \
+    __cpp_lib_atomic_shared_ptr >= 201711L
+using PoolHolder = std::atomic<std::shared_ptr<ThreadPool>>;
+std::shared_ptr<ThreadPool> load(const PoolHolder& holder) {
+  return holder.load();
+}
+void store(PoolHolder& holder, std::shared_ptr<ThreadPool> arg) {
+  holder.store(std::move(arg));
+}
+#else
+using PoolHolder = std::shared_ptr<ThreadPool>;
+std::shared_ptr<ThreadPool> load(const PoolHolder& holder) {
+  return std::atomic_load(&holder);
+}
+void store(PoolHolder& holder, std::shared_ptr<ThreadPool> arg) {
+  std::atomic_store(&holder, std::move(arg));
+}
+#endif
+
+/// a worker cannot join itself, hence a pool released by one of its own
+/// workers is destroyed by a helper thread
+void destroy_pool(ThreadPool* pool) {
+  if (pool->is_worker())
+    std::thread([pool]() { delete pool; }).detach();
+  else
+    delete pool;
+}
+
+}  // namespace
+
+std::shared_ptr<ThreadPool> ThreadPool::instance() {
+  // the pool is obtained by every parallel region but rarely replaced, hence
+  // readers load a snapshot, and only the writers are serialized
+  static PoolHolder holder;
+  static std::mutex mtx;
+  const std::size_t nworkers = std::max(num_threads(), 1) - 1;
+  if (auto pool = load(holder); pool && pool->nworkers() == nworkers)
+    return pool;
+  std::scoped_lock<std::mutex> lock(mtx);
+  auto pool = load(holder);
+  if (!pool || pool->nworkers() != nworkers) {
+    pool = std::shared_ptr<ThreadPool>(new ThreadPool(nworkers), destroy_pool);
+    store(holder, pool);
+  }
+  return pool;
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::current() {
+  if (this_thread_pool) return this_thread_pool->shared_from_this();
+  return instance();
+}
+
+bool ThreadPool::is_worker() const { return this_thread_pool == this; }
+
+void ThreadPool::submit(Task task) {
+  auto& queue =
+      is_worker() ? *queues_[this_thread_worker_id] : injection_queue_;
+  {
+    std::scoped_lock<std::mutex> lock(queue.mtx);
+    queue.tasks.emplace_back(std::move(task));
+  }
+  {
+    // increment under mtx_ so that workers going to sleep do not miss it
+    std::scoped_lock<std::mutex> lock(mtx_);
+    npending_.fetch_add(1, std::memory_order_release);
+  }
+  cv_.notify_one();
+}
+
+bool ThreadPool::try_pop(Task& task) {
+  if (npending_.load(std::memory_order_acquire) == 0) return false;
+
+  auto pop = [&task, this](WorkerQueue& queue, bool back) {
+    std::scoped_lock<std::mutex> lock(queue.mtx);
+    if (queue.tasks.empty()) return false;
+    if (back) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    npending_.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+  };
+
+  // 1. own queue, LIFO to keep the working set hot
+  const auto nqueues = queues_.size();
+  const bool is_worker = this->is_worker();
+  if (is_worker && pop(*queues_[this_thread_worker_id], true)) return true;
+  // 2. tasks injected from the outside
+  if (pop(injection_queue_, false)) return true;
+  // 3. steal the oldest (i.e. likely the largest) tasks of other workers
+  const std::size_t first_victim = is_worker ? this_thread_worker_id + 1 : 0;
+  for (std::size_t v = 0; v != nqueues; ++v) {
+    const auto victim = (first_victim + v) % nqueues;
+    if (is_worker && victim == this_thread_worker_id) continue;
+    if (pop(*queues_[victim], false)) return true;
+  }
+  return false;
+}
+
+bool ThreadPool::try_run_one() {
+  Task task;
+  if (!try_pop(task)) return false;
+  task();
+  return true;
+}
+
+void ThreadPool::run_until(const std::function<bool()>& done) {
+  while (!done()) {
+    if (try_run_one()) continue;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this, &done]() {
+      return done() || npending_.load(std::memory_order_acquire) != 0;
+    });
+  }
+  // if woken up by submit() pass the wakeup on to the workers
+  if (npending_.load(std::memory_order_acquire) != 0) cv_.notify_one();
+}
+
+void ThreadPool::notify_waiters() {
+  // synchronize with the waiters that are evaluating their predicate
+  { std::scoped_lock<std::mutex> lock(mtx_); }
+  cv_.notify_all();
+}
+
+void ThreadPool::worker_loop(std::size_t worker_id) {
+  this_thread_pool = this;
+  this_thread_worker_id = worker_id;
+  while (true) {
+    if (try_run_one()) continue;
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this]() {
+      return stop_ || npending_.load(std::memory_order_acquire) != 0;
+    });
+    if (stop_ && npending_.load(std::memory_order_acquire) == 0) break;
+  }
+  this_thread_pool = nullptr;
+}
+
+}  // namespace sequant::detail
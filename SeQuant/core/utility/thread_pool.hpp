@@ -0,0 +1,177 @@
+#ifndef SEQUANT_CORE_UTILITY_THREAD_POOL_HPP
+#define SEQUANT_CORE_UTILITY_THREAD_POOL_HPP
+
+#include <SeQuant/core/utility/memory_resource.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sequant::detail {
+
+// clang-format off
+/// @brief A persistent work-stealing pool of threads
+
+/// Each worker owns a deque of tasks; tasks submitted from a worker thread
+/// go to the back of its own deque, tasks submitted from any other thread go
+/// into a shared injection queue. Idle workers pop from the back of their own
+/// deque, then from the injection queue, and then steal from the front of
+/// the other workers' deques. Threads that wait for tasks to complete (see
+/// TaskGroup::wait()) execute pending tasks while waiting, hence nested
+/// parallel regions do not oversubscribe the cores and do not deadlock.
+///
+/// The process-wide pool is obtained via ThreadPool::instance(); it has
+/// `num_threads()-1` workers since the thread submitting the work also
+/// participates in it.
+// clang-format on
+class ThreadPool : public std::enable_shared_from_this<ThreadPool> {
+ public:
+  using Task = std::function<void()>;
+
+  /// @param nworkers the number of worker threads; if zero, all tasks are
+  /// executed by the threads waiting for them
+  explicit ThreadPool(std::size_t nworkers);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  /// stops the workers after all pending tasks have been executed
+  ~ThreadPool();
+
+  /// @return the process-wide pool with `num_threads()-1` workers; the pool
+  /// is (re)created if `num_threads()` changed since the last call
+  /// @note the work in flight when the number of threads is changed
+  /// completes using the old pool, which is destroyed when its last task
+  /// group releases it; if that happens on one of its own workers the
+  /// destruction is handed off to a helper thread
+  static std::shared_ptr<ThreadPool> instance();
+
+  /// @return the pool to which the calling thread belongs, if called by a
+  /// worker thread, else instance()
+  static std::shared_ptr<ThreadPool> current();
+
+  /// @return the number of worker threads
+  std::size_t nworkers() const { return workers_.size(); }
+
+  /// @return true if the calling thread is a worker of this pool
+  bool is_worker() const;
+
+  /// enqueues @p task for execution
+  void submit(Task task);
+
+  /// executes one pending task, if any
+  /// @return true if a task was executed
+  bool try_run_one();
+
+  /// executes pending tasks until @p done returns true; blocks while there
+  /// are no pending tasks
+  /// @param done a predicate; the thread making it true must call
+  /// notify_waiters() afterwards
+  void run_until(const std::function<bool()>& done);
+
+  /// wakes up the threads blocked in run_until()
+  void notify_waiters();
+
+ private:
+  struct WorkerQueue {
+    std::mutex mtx;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;  // one per worker
+  WorkerQueue injection_queue_;  // tasks submitted by non-workers
+
+  std::mutex mtx_;  // guards the sleeping of workers and waiters
+  std::condition_variable cv_;
+  std::atomic<std::size_t> npending_ = 0;  // # of tasks in all queues
+  bool stop_ = false;
+
+  bool try_pop(Task& task);
+  void worker_loop(std::size_t worker_id);
+};
+
+/// @brief A group of tasks executed by a ThreadPool that can be waited on
+
+/// Tasks are submitted by run() and awaited by wait(). The first exception
+/// thrown by a task is captured and rethrown by wait(). Each task is executed
+/// with the Expr memory resource (see ScopedExprMemoryResource) that was
+/// installed on the submitting thread.
+/// @note the destructor waits for the completion of the outstanding tasks,
+/// hence tasks can safely refer to the objects on the stack of the thread
+/// that created the group.
+class TaskGroup {
+ public:
+  /// @param pool the pool that will execute the tasks
+  explicit TaskGroup(std::shared_ptr<ThreadPool> pool = ThreadPool::current())
+      : pool_(std::move(pool)) {}
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  ~TaskGroup() {
+    try {
+      wait();
+    } catch (...) {
+    }
+  }
+
+  /// @return the pool used by this group
+  ThreadPool& pool() const { return *pool_; }
+
+  /// submits @p f for execution
+  /// @tparam F a callable type for which `F()` is valid
+  template <typename F>
+  void run(F&& f) {
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    pool_->submit([this, f = std::forward<F>(f),
+                   resource = expr_memory_resource()]() mutable {
+      ScopedExprMemoryResource scoped_resource(std::move(resource));
+      try {
+        f();
+      } catch (...) {
+        std::scoped_lock<std::mutex> lock(eptr_mtx_);
+        if (!eptr_) eptr_ = std::current_exception();
+      }
+      // N.B. this group may be destroyed as soon as outstanding_ drops to 0
+      auto* pool = pool_.get();
+      if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        pool->notify_waiters();
+    });
+  }
+
+  /// waits for all tasks submitted so far to complete, executing pending
+  /// tasks of the pool while waiting and blocking when there are none
+  /// @throw the first exception thrown by a task
+  void wait() {
+    pool_->run_until([this]() {
+      return outstanding_.load(std::memory_order_acquire) == 0;
+    });
+    std::exception_ptr eptr;
+    {
+      std::scoped_lock<std::mutex> lock(eptr_mtx_);
+      std::swap(eptr, eptr_);
+    }
+    if (eptr) std::rethrow_exception(eptr);
+  }
+
+ private:
+  std::shared_ptr<ThreadPool> pool_;
+  std::atomic<std::size_t> outstanding_ = 0;
+  std::mutex eptr_mtx_;
+  std::exception_ptr eptr_;
+};
+
+}  // namespace sequant::detail
+
+#endif  // SEQUANT_CORE_UTILITY_THREAD_POOL_HPP
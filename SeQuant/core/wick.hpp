@@ -5,8 +5,19 @@
 #ifndef SEQUANT_WICK_HPP
 #define SEQUANT_WICK_HPP
 
+#include <array>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
 #include <utility>
 
 #include <SeQuant/core/math.hpp>
@@ -14,6 +25,7 @@
 #include <SeQuant/core/ranges.hpp>
 #include <SeQuant/core/runtime.hpp>
 #include <SeQuant/core/tensor.hpp>
+#include <SeQuant/core/wick_cache.hpp>
 
 namespace sequant {
 
@@ -55,6 +67,7 @@ class WickTheorem {
       const std::shared_ptr<NormalOperatorSequence<S>> &input) {
     init_input(input);
     assert(input_->size() <= max_input_size);
+    assert(input_->opsize() <= max_input_opsize);
     assert(input_->empty() || input_->vacuum() != Vacuum::Invalid);
     if constexpr (statistics == Statistics::BoseEinstein) {
       assert(input_->empty() || input_->vacuum() == Vacuum::Physical);
@@ -129,6 +142,26 @@ class WickTheorem {
     return *this;
   }
 
+  /// the type of callables that consume the terms produced by compute()
+  using sink_type = std::function<void(ExprPtr)>;
+
+  /// Controls whether compute() collects the terms of the result or hands
+  /// each term to a callable as soon as it is produced. The terms passed to
+  /// @p sink are reduced and canonicalized individually, as compute() would,
+  /// but are not combined with each other; this keeps the memory footprint
+  /// independent of the number of terms. By default the terms are collected.
+  /// @param sink the callable that consumes the terms; if null, compute()
+  /// collects the terms. The calls to @p sink are serialized, but can be made
+  /// from any thread.
+  /// @return reference to @c *this , for daisy-chaining
+  /// @note if @p sink is nonnull, compute() returns zero unless @c
+  /// count_only is true
+  WickTheorem &set_sink(sink_type sink) {
+    sink_ = std::move(sink);
+    sink_mtx_ = sink_ ? std::make_shared<std::mutex>() : nullptr;
+    return *this;
+  }
+
   /// Specifies the external indices; by default assume all indices are summed
   /// over
   /// @param external_indices external (nonsummed) indices
@@ -391,33 +424,135 @@ class WickTheorem {
   ExprPtr compute(bool count_only = false,
                   bool skip_input_canonicalization = false);
 
-  /// Collects compute statistics
+  /// Collects compute statistics; the statistics of the summands of an Expr
+  /// input, computed in parallel, are aggregated
+  /// @note the results found in WickCache are only counted by
+  /// num_cache_hits, i.e. they do not contribute to the other statistics
   class Stats {
    public:
-    Stats() : num_attempted_contractions(0), num_useful_contractions(0) {}
-    Stats(const Stats &other) noexcept {
-      num_attempted_contractions.store(other.num_attempted_contractions.load());
-      num_useful_contractions.store(other.num_useful_contractions.load());
+    /// the phases of compute() whose duration is measured
+    enum class Phase : std::size_t {
+      canonicalize_input,   //!< canonicalization of the input expression
+      topology,             //!< topological partitioning (via bliss)
+      recursion,            //!< enumeration of contractions
+      reduce,               //!< reduction of overlaps (index replacement)
+      canonicalize_result,  //!< canonicalization of the result
+    };
+    static constexpr std::size_t nphases = 5;
+
+    /// @return the name of phase @p p
+    static const char *to_string(Phase p) {
+      constexpr std::array<const char *, nphases> names = {
+          "canonicalize_input", "topology", "recursion", "reduce",
+          "canonicalize_result"};
+      return names[static_cast<std::size_t>(p)];
     }
+
+    /// measures the duration of a phase between its construction and
+    /// destruction, and adds it to the stats
+    class PhaseTimer {
+     public:
+      PhaseTimer(Stats &stats, Phase phase)
+          : stats_(stats),
+            phase_(phase),
+            start_(std::chrono::steady_clock::now()) {}
+      PhaseTimer(const PhaseTimer &) = delete;
+      PhaseTimer &operator=(const PhaseTimer &) = delete;
+      ~PhaseTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start_;
+        stats_.phase_ns[static_cast<std::size_t>(phase_)] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count();
+      }
+
+     private:
+      Stats &stats_;
+      Phase phase_;
+      std::chrono::steady_clock::time_point start_;
+    };
+
+    Stats() { reset(); }
+    Stats(const Stats &other) noexcept { *this = other; }
     Stats &operator=(const Stats &other) noexcept {
       num_attempted_contractions.store(other.num_attempted_contractions.load());
       num_useful_contractions.store(other.num_useful_contractions.load());
+      num_visited_nodes.store(other.num_visited_nodes.load());
+      num_pruned_branches.store(other.num_pruned_branches.load());
+      num_terms.store(other.num_terms.load());
+      num_term_bytes.store(other.num_term_bytes.load());
+      num_cache_hits.store(other.num_cache_hits.load());
+      for (std::size_t p = 0; p != nphases; ++p)
+        phase_ns[p].store(other.phase_ns[p].load());
       return *this;
     }
 
     void reset() {
       num_attempted_contractions = 0;
       num_useful_contractions = 0;
+      num_visited_nodes = 0;
+      num_pruned_branches = 0;
+      num_terms = 0;
+      num_term_bytes = 0;
+      num_cache_hits = 0;
+      for (auto &ns : phase_ns) ns = 0;
     }
 
     Stats &operator+=(const Stats &other) {
       num_attempted_contractions += other.num_attempted_contractions;
       num_useful_contractions += other.num_useful_contractions;
+      num_visited_nodes += other.num_visited_nodes;
+      num_pruned_branches += other.num_pruned_branches;
+      num_terms += other.num_terms;
+      num_term_bytes += other.num_term_bytes;
+      num_cache_hits += other.num_cache_hits;
+      for (std::size_t p = 0; p != nphases; ++p)
+        phase_ns[p] += other.phase_ns[p];
       return *this;
     }
 
+    /// @return a PhaseTimer that measures phase @p p until it is destroyed
+    [[nodiscard]] PhaseTimer time(Phase p) { return PhaseTimer(*this, p); }
+
+    /// @return the time spent in phase @p p, in seconds, summed over threads
+    double elapsed(Phase p) const {
+      return phase_ns[static_cast<std::size_t>(p)].load() * 1e-9;
+    }
+
+    /// @return the stats as a JSON object
+    std::string to_json() const {
+      std::ostringstream oss;
+      oss << "{\"num_attempted_contractions\": "
+          << num_attempted_contractions.load()
+          << ", \"num_useful_contractions\": " << num_useful_contractions.load()
+          << ", \"num_visited_nodes\": " << num_visited_nodes.load()
+          << ", \"num_pruned_branches\": " << num_pruned_branches.load()
+          << ", \"num_terms\": " << num_terms.load()
+          << ", \"num_term_bytes\": " << num_term_bytes.load()
+          << ", \"num_cache_hits\": " << num_cache_hits.load()
+          << ", \"elapsed_seconds\": {";
+      for (std::size_t p = 0; p != nphases; ++p) {
+        oss << (p == 0 ? "" : ", ") << "\"" << to_string(static_cast<Phase>(p))
+            << "\": " << elapsed(static_cast<Phase>(p));
+      }
+      oss << "}}";
+      return oss.str();
+    }
+
     std::atomic<size_t> num_attempted_contractions;
     std::atomic<size_t> num_useful_contractions;
+    /// # of nodes of the contraction tree visited by the recursion
+    std::atomic<size_t> num_visited_nodes;
+    /// # of branches of the contraction tree skipped because they cannot
+    /// produce full contractions
+    std::atomic<size_t> num_pruned_branches;
+    /// # of terms produced by the recursion (before reduction)
+    std::atomic<size_t> num_terms;
+    /// # of bytes allocated for buffering the terms produced by the recursion
+    std::atomic<size_t> num_term_bytes;
+    /// # of Product inputs whose result was found in WickCache
+    std::atomic<size_t> num_cache_hits;
+    /// the time spent in each Phase, in nanoseconds
+    std::array<std::atomic<std::uint64_t>, nphases> phase_ns;
   };
 
   /// Statistics accessor
@@ -436,6 +571,8 @@ class WickTheorem {
  private:
   static constexpr size_t max_input_size =
       32;  // max # of operators in the input sequence
+  static constexpr size_t max_input_opsize =
+      128;  // max # of Op<S> objects in the input sequence
 
   // if nonnull, apply wick to the whole expression recursively, else input_ is
   // set this is mutated by compute
@@ -446,6 +583,11 @@ class WickTheorem {
   bool use_topology_ = false;
   mutable Stats stats_;
 
+  sink_type sink_;  // if nonnull, consumes the terms
+  std::shared_ptr<std::mutex> sink_mtx_;  // serializes the calls to sink_
+  // if nonnull, the terms are multiplied by this and reduced before sinking
+  mutable ExprPtr sink_prefactor_;
+
   mutable std::optional<container::set<Index>>
       external_indices_;  // lack of external indices != all indices are
                           // internal
@@ -485,6 +627,10 @@ class WickTheorem {
   /// to map op object to the topological partitions need to be able to map them
   /// to their ordinals in input_
   mutable container::map<Op<S>, std::size_t> op_to_input_ordinal_;
+  /// for each Op in input_ (in the order of input ordinals) specifies the
+  /// bitmask of Ops that it can be contracted with (1 = can contract);
+  /// only used if full_contractions_==true
+  mutable container::svector<std::bitset<max_input_opsize>> op_partners_;
   friend class NontensorWickState;  // NontensorWickState needs to access
                                     // members of this
 
@@ -590,15 +736,77 @@ class WickTheorem {
     // initialize op partitions, if not done so
     if (input_->opsize() > 0 && op_npartitions_ == 0)
       make_default_op_partitions();
+    // tabulate contractible Op pairs, used to prune dead-end contractions
+    if (full_contractions_) make_op_partners();
 
     // now compute
     auto result = compute_nontensor_wick(count_only);
     return result;
   }
 
+  /// populates op_partners_
+  void make_op_partners() const {
+    // {Op, ordinal of its NormalOperator} for each Op, in input order
+    container::svector<std::pair<const Op<S> *, std::size_t>> ops;
+    for (auto &&[nop_idx, nop] : ranges::views::enumerate(*input_))
+      for (auto &&op : nop)
+        ops.emplace_back(&op, static_cast<std::size_t>(nop_idx));
+
+    const auto nops = ops.size();
+    assert(nops <= max_input_opsize);
+    op_partners_.assign(nops, std::bitset<max_input_opsize>{});
+    for (std::size_t i = 0; i != nops; ++i) {
+      for (std::size_t j = i + 1; j != nops; ++j) {
+        if (ops[i].second != ops[j].second &&
+            can_contract(*ops[i].first, *ops[j].first, input_->vacuum())) {
+          op_partners_[i].set(j);
+          op_partners_[j].set(i);
+        }
+      }
+    }
+  }
+
+  /// the contractions produced by the recursion: each is a (prefactor,
+  /// uncontracted normal operator) pair, the latter is null for full
+  /// contractions
+  using nontensor_wick_result_type =
+      std::vector<std::pair<Product, std::shared_ptr<NormalOperator<S>>>>;
+
+  /// results of the tasks exploring the contraction tree; each task collects
+  /// its contractions into its own buffer, no locking is needed until the
+  /// task is done
+  struct NontensorWickTaskResults {
+    std::mutex mtx;  // serializes updates of buffers
+    std::vector<nontensor_wick_result_type> buffers;
+    /// # of the useful contractions whose recursion may have spawned tasks
+    /// (see NontensorWickState::useful_flags)
+    std::atomic<size_t> num_useful_flagged_contractions = 0;
+  };
+
   /// carries state down the stack of recursive calls
+  /// @tparam Capacity the max number of NormalOperators in the input; the
+  /// connectivity and topological partition data is sized at compile time
+  /// for this many NormalOperators and for op_capacity Op<S> objects, hence
+  /// it does not need heap allocation
+  /// @note the prefactor, the operator sequence, and the list of
+  /// contractions are still heap-allocated
+  template <std::size_t Capacity>
   struct NontensorWickState {
+    static_assert(Capacity > 1 && Capacity <= max_input_size);
+
    public:
+    /// the max number of Op<S> objects in the input
+    static constexpr std::size_t op_capacity = 4 * Capacity;
+    static_assert(op_capacity <= max_input_opsize);
+
+    /// bitmask of connections of a NormalOperator
+    using nop_connections_type = std::bitset<Capacity>;
+    /// bitmask of the NormalOperators in a topological partition
+    using nop_partition_type = std::bitset<Capacity>;
+    /// counts contractions of Op<S> partitions, at most max_input_opsize
+    using op_count_type = std::uint8_t;
+    static_assert(max_input_opsize <=
+                  std::numeric_limits<op_count_type>::max());
     /// @return the number of elements in a lower triangle of an `n` by `n`
     /// matrix
     template <typename T>
@@ -644,11 +852,46 @@ class WickTheorem {
           count(0),
           nop_connections(nopseq.size()),
           nop_adjacency_matrix(ntri(nopseq.size()), 0),
-          nop_nconnections(nopseq.size(), 0) {
+          nop_nconnections(nopseq.size(), 0),
+          root_count(&count) {
+      assert(nopseq.size() <= Capacity);
+      assert(nopseq.opsize() <= op_capacity);
+      for (std::size_t op = 0; op != nopseq.opsize(); ++op)
+        uncontracted_ops.set(op);
+      // N.B. bits past Capacity refer to nonexistent NormalOperators
+      for (auto &&connections : wt.nop_connections_)
+        target_nop_connections.emplace_back(connections.to_ulong());
       init_topological_partitions();
     }
 
-    NontensorWickState(const NontensorWickState &) = delete;
+    /// copies the state of the recursion, used to explore a branch of the
+    /// contraction tree by a separate task
+    /// @note the count of the copy is zero, it should be added to
+    /// `*root_count` when the branch has been explored
+    explicit NontensorWickState(const NontensorWickState &other)
+        : wick(other.wick),
+          nopseq(other.nopseq),
+          nopseq_size(other.nopseq_size),
+          sp(other.sp.deep_copy()),
+          contractions(other.contractions),
+          level(other.level),
+          left_op_offset(other.left_op_offset),
+          count_only(other.count_only),
+          count(0),
+          nop_connections(other.nop_connections),
+          target_nop_connections(other.target_nop_connections),
+          nop_adjacency_matrix(other.nop_adjacency_matrix),
+          nop_nconnections(other.nop_nconnections),
+          nop_partitions(other.nop_partitions),
+          op_partition_cdeg_matrix(other.op_partition_cdeg_matrix),
+          op_partition_ncontractions(other.op_partition_ncontractions),
+          uncontracted_ops(other.uncontracted_ops),
+          tasks(other.tasks),
+          task_results(other.task_results),
+          root_count(other.root_count),
+          num_useful_contractions(0),
+          useful_flags(other.useful_flags) {}
+
     NontensorWickState(NontensorWickState &&) = delete;
     NontensorWickState &operator=(const NontensorWickState &) = delete;
     NontensorWickState &operator=(NontensorWickState &&) = delete;
@@ -670,23 +913,27 @@ class WickTheorem {
                       //!< complete contractions only)
     std::atomic<size_t> count;  //!< if count_only is true, will count the
                                 //!< total number of terms
-    container::svector<std::bitset<max_input_size>>
+    container::svector<nop_connections_type, Capacity>
         nop_connections;  //!< bitmask of connections for each nop (1 =
                           //!< connected)
-    container::svector<size_t>
+    container::svector<nop_connections_type, Capacity>
+        target_nop_connections;  //!< copy of WickTheorem::nop_connections_
+                                 //!< (0 = connection required), empty if
+                                 //!< connectivity is not constrained
+    container::svector<size_t, Capacity * (Capacity - 1) / 2>
         nop_adjacency_matrix;  //!< number of connections between each nop, only
                                //!< lower triangle is kept
 
     /// for each NormalOperator specifies how many connections it currently has
     /// @note exists to avoid the need to traverse nop_adjacency_matrix
-    container::svector<size_t> nop_nconnections;
+    container::svector<size_t, Capacity> nop_nconnections;
     /// current state of nop partitions (will only match contents of
     /// nop_to_partition before any contractions have occurred)
     /// - when a normal operator is connected it's removed from the partition
     /// - when it is disconnected fully it's re-added to the partition
-    container::svector<container::set<size_t>> nop_partitions;
+    container::svector<nop_partition_type, Capacity> nop_partitions;
 
-    container::svector<size_t>
+    container::svector<op_count_type, op_capacity * (op_capacity - 1) / 2>
         op_partition_cdeg_matrix;  //!< contraction degree
                                    //!< (number of contractions) between
                                    //!< each topologically-equivalent group
@@ -696,7 +943,86 @@ class WickTheorem {
     /// for each Op<S> partition specifies how many contractions it currently
     /// has
     /// @note exists to avoid the need to traverse op_partition_cdeg_matrix
-    container::svector<size_t> op_partition_ncontractions;
+    container::svector<op_count_type, op_capacity> op_partition_ncontractions;
+
+    /// bitmask of the Ops of the input that are not contracted (1 = not
+    /// contracted), in the order of input ordinals
+    std::bitset<max_input_opsize> uncontracted_ops;
+
+    /// @return false if the uncontracted Ops cannot be fully contracted,
+    /// i.e. if their number is odd or one of them has no contraction partner
+    /// among them
+    /// @pre `wick.op_partners_` has been populated
+    bool can_contract_fully() const {
+      if (uncontracted_ops.count() % 2 != 0) return false;
+      const auto nops = wick.op_partners_.size();
+      for (std::size_t op = 0; op != nops; ++op) {
+        if (uncontracted_ops[op] &&
+            (wick.op_partners_[op] & uncontracted_ops).none())
+          return false;
+      }
+      return true;
+    }
+
+    /// if nonnull, the top levels of the contraction tree are explored by
+    /// the tasks of this group
+    detail::TaskGroup *tasks = nullptr;
+    /// collects the results of the tasks spawned by the recursion
+    NontensorWickTaskResults *task_results = nullptr;
+    /// the count of the state at the root of the recursion
+    std::atomic<size_t> *root_count;
+
+    /// the deepest level of the contraction tree whose branches are
+    /// explored by separate tasks
+    static constexpr int max_task_level = 2;
+    /// branches with fewer ops left are not worth a separate task
+    static constexpr std::size_t min_task_nopseq_size = 6;
+
+    /// @return true if the branch of the contraction tree rooted at this
+    /// state should be explored by a separate task
+    bool spawn_task() const {
+      return tasks != nullptr && level <= max_task_level &&
+             nopseq_size >= min_task_nopseq_size;
+    }
+
+    /// # of useful contractions found by this state, see
+    /// WickTheorem::Stats::num_useful_contractions; the copy made for a task
+    /// counts from zero
+    size_t num_useful_contractions = 0;
+    /// the other stats counted by this state, see WickTheorem::Stats; like
+    /// num_useful_contractions they are plain counters, local to the task
+    /// that owns the state, and are folded into WickTheorem::stats_ by
+    /// fold_stats() once the task is done
+    /// @{
+    size_t num_visited_nodes = 0;
+    size_t num_pruned_branches = 0;
+    size_t num_attempted_contractions = 0;
+    size_t num_terms = 0;
+    /// @}
+
+    /// adds the counts of this state, except num_useful_contractions, to
+    /// WickTheorem::stats_
+    void fold_stats() const {
+      auto &stats = wick.stats_;
+      stats.num_visited_nodes += num_visited_nodes;
+      stats.num_pruned_branches += num_pruned_branches;
+      stats.num_attempted_contractions += num_attempted_contractions;
+      stats.num_terms += num_terms;
+    }
+    /// the flags of the contractions on the current path of the contraction
+    /// tree whose recursion may have spawned tasks; such contraction is
+    /// useful if any task spawned below it is, hence its usefulness is only
+    /// known once the tasks complete
+    container::svector<std::shared_ptr<std::atomic<bool>>, max_task_level>
+        useful_flags;
+
+    /// marks the contractions in useful_flags as useful
+    void mark_flagged_contractions_useful() {
+      for (auto &flag : useful_flags) {
+        if (!flag->exchange(true))
+          ++task_results->num_useful_flagged_contractions;
+      }
+    }
 
     /// "applies" this->contractions to the partner index pairs from
     /// this->wick.input_partner_indices_ to produce the current target list of
@@ -775,14 +1101,14 @@ class WickTheorem {
         ranges::for_each(wick.nop_partition_idx_,
                          [this, &cnt](size_t partition_idx) {
                            if (partition_idx > 0) {  // in a partition
-                             nop_partitions.at(partition_idx - 1).insert(cnt);
+                             nop_partitions.at(partition_idx - 1).set(cnt);
                            }
                            ++cnt;
                          });
         // assert that we don't have empty partitions due to broken logic
         // upstream
         assert(ranges::any_of(nop_partitions, [](auto &&partition) {
-                 return partition.empty();
+                 return partition.none();
                }) == false);
       }
 
@@ -803,9 +1129,7 @@ class WickTheorem {
     /// If the target connectivity will be violated by this contraction, keep
     /// the state unchanged and return false
     template <typename Cursor>
-    inline bool connect(const container::svector<std::bitset<max_input_size>>
-                            &target_nop_connections,
-                        const Cursor &op1_cursor, const Cursor &op2_cursor) {
+    inline bool connect(const Cursor &op1_cursor, const Cursor &op2_cursor) {
       assert(op1_cursor.ordinal() < op2_cursor.ordinal());
 
       // add contraction to the grand list
@@ -826,9 +1150,8 @@ class WickTheorem {
           auto partition_idx = wick.nop_partition_idx_[nop_idx];
           if (nconnections == 0 && partition_idx > 0) {
             --partition_idx;  // to 0-based
-            assert(nop_partitions.at(partition_idx).size() > 0);
-            auto removed = nop_partitions[partition_idx].erase(nop_idx);
-            assert(removed);
+            assert(nop_partitions.at(partition_idx).test(nop_idx));
+            nop_partitions[partition_idx].reset(nop_idx);
           }
         }
         ++nop_nconnections[nop_idx];
@@ -923,9 +1246,8 @@ class WickTheorem {
 
     /// @brief Updates connectivity when contraction is reversed
     template <typename Cursor>
-    inline void disconnect(const container::svector<std::bitset<max_input_size>>
-                               &target_nop_connections,
-                           const Cursor &op1_cursor, const Cursor &op2_cursor) {
+    inline void disconnect(const Cursor &op1_cursor,
+                           const Cursor &op2_cursor) {
       assert(op1_cursor.ordinal() < op2_cursor.ordinal());
 
       auto unregister_contraction = [&]() {
@@ -944,8 +1266,8 @@ class WickTheorem {
           auto partition_idx = wick.nop_partition_idx_[nop_idx];
           if (nconnections == 0 && partition_idx > 0) {
             --partition_idx;  // to 0-based
-            auto inserted = nop_partitions.at(partition_idx).insert(nop_idx);
-            assert(inserted.second);
+            assert(!nop_partitions.at(partition_idx).test(nop_idx));
+            nop_partitions[partition_idx].set(nop_idx);
           }
         }
       };
@@ -1003,15 +1325,17 @@ class WickTheorem {
     }
   };  // NontensorWickState
 
-  /// Applies most naive version of Wick's theorem, where the sign rule involves
-  /// counting Ops
-  /// @return the result
-  ExprPtr compute_nontensor_wick(const bool count_only) const {
-    std::vector<std::pair<Product, std::shared_ptr<NormalOperator<S>>>>
-        result;      //!< current value of the result
-    std::mutex mtx;  // used in critical sections updating the result
-    auto result_plus_mutex = std::make_pair(&result, &mtx);
-    NontensorWickState state(*this, *input_);
+  /// Enumerates the contractions of input_ using the state of capacity
+  /// @p Capacity
+  /// @param[out] result the contractions, unless @p count_only is true
+  /// @param count_only if true, will only count the contractions
+  /// @return the number of contractions if @p count_only is true
+  template <std::size_t Capacity>
+  std::size_t enumerate_contractions(nontensor_wick_result_type &result,
+                                     const bool count_only) const {
+    NontensorWickTaskResults task_results;
+    NontensorWickState<Capacity> state(*this, *input_);
+    state.task_results = &task_results;
     state.count_only = count_only;
     // TODO extract index->particle maps
 
@@ -1019,25 +1343,82 @@ class WickTheorem {
       std::wcout << "nop topological partitions: {\n";
       for (auto &&toppart : state.nop_partitions) {
         std::wcout << "{" << std::endl;
-        for (auto &&op_idx : toppart) {
-          std::wcout << op_idx << std::endl;
+        for (std::size_t nop_idx = 0; nop_idx != toppart.size(); ++nop_idx) {
+          if (toppart[nop_idx]) std::wcout << nop_idx << std::endl;
         }
         std::wcout << "}" << std::endl;
       }
       std::wcout << "}" << std::endl;
     }
 
-    recursive_nontensor_wick(result_plus_mutex, state);
+    // explore the top of the contraction tree in parallel
+    std::optional<detail::TaskGroup> tasks;
+    if (num_threads() > 1) {
+      tasks.emplace();
+      state.tasks = &tasks.value();
+    }
+
+    if (!full_contractions_ || state.can_contract_fully())
+      recursive_nontensor_wick(result, state);
+    if (tasks) tasks->wait();
+    state.fold_stats();
+    stats_.num_useful_contractions +=
+        state.num_useful_contractions +
+        task_results.num_useful_flagged_contractions.load();
+
+    // merge the results of the tasks
+    constexpr auto term_size =
+        sizeof(typename nontensor_wick_result_type::value_type);
+    for (auto &buffer : task_results.buffers)
+      stats_.num_term_bytes += buffer.capacity() * term_size;
+    if (!task_results.buffers.empty()) {
+      result.reserve(ranges::accumulate(
+          task_results.buffers, result.size(),
+          [](std::size_t n, const auto &buffer) { return n + buffer.size(); }));
+      for (auto &buffer : task_results.buffers) {
+        result.insert(result.end(), std::make_move_iterator(buffer.begin()),
+                      std::make_move_iterator(buffer.end()));
+      }
+      task_results.buffers.clear();
+    }
+    stats_.num_term_bytes += result.capacity() * term_size;
+
+    return state.count.load();
+  }
+
+  /// Applies most naive version of Wick's theorem, where the sign rule involves
+  /// counting Ops
+  /// @return the result
+  ExprPtr compute_nontensor_wick(const bool count_only) const {
+    auto timer = stats_.time(Stats::Phase::recursion);
+    nontensor_wick_result_type result;  //!< current value of the result
+    std::size_t count = 0;
+
+    // if only counting, avoid enumerating the contractions, if possible
+    if (count_only && can_count_contractions()) {
+      // N.B. the contraction-free term is accounted for below
+      count = count_contractions() - (full_contractions_ ? 0 : 1);
+    } else {
+      // use the most compact state that fits the input
+      const auto nnops = input_->size();
+      const auto nops = input_->opsize();
+      if (nnops <= 8 && nops <= NontensorWickState<8>::op_capacity)
+        count = enumerate_contractions<8>(result, count_only);
+      else if (nnops <= 16 && nops <= NontensorWickState<16>::op_capacity)
+        count = enumerate_contractions<16>(result, count_only);
+      else
+        count = enumerate_contractions<max_input_size>(result, count_only);
+    }
 
     // if computing everything, and the user does not insist on some
     // target contractions, include the contraction-free term
     if (!full_contractions_ && nop_nconnections_total_ == 0) {
       if (count_only) {
-        ++state.count;
+        ++count;
       } else {
         auto [phase, normop] = normalize(*input_, input_partner_indices_);
-        result_plus_mutex.first->push_back(
-            std::make_pair(Product(phase, {}), std::move(normop)));
+        ++stats_.num_terms;
+        add_contraction(result, Product(phase, {}), std::move(normop));
       }
     }
 
@@ -1046,50 +1427,210 @@ class WickTheorem {
     ExprPtr result_expr;
     if (count_only) {  // count only? return the total number as a Constant
       assert(result.empty());
-      result_expr = ex<Constant>(state.count.load());
+      result_expr = ex<Constant>(count);
     } else if (result.size() == 1) {  // if result.size() == 1, return Product
-      auto product = std::make_shared<Product>(std::move(result.at(0).first));
+      result_expr = ex<Product>(std::move(result.at(0).first));
       if (full_contractions_)
         assert(result.at(0).second == nullptr);
       else {
         if (result.at(0).second)
-          product->append(1, std::move(result.at(0).second));
+          result_expr->as<Product>().append(1,
+                                            std::move(result.at(0).second));
       }
-      result_expr = product;
     } else if (result.size() > 1) {
-      auto sum = std::make_shared<Sum>();
+      result_expr = ex<Sum>();
+      auto &sum = result_expr->as<Sum>();
       for (auto &&term : result) {
         if (full_contractions_) {
           assert(term.second == nullptr);
-          sum->append(ex<Product>(std::move(term.first)));
+          sum.append(ex<Product>(std::move(term.first)));
         } else {
-          auto term_product = std::make_shared<Product>(std::move(term.first));
+          auto term_product = ex<Product>(std::move(term.first));
           if (term.second) {
-            term_product->append(1, term.second);
+            term_product->as<Product>().append(1, term.second);
           }
-          sum->append(term_product);
+          sum.append(term_product);
         }
       }
-      result_expr = sum;
     } else if (result_expr == nullptr)
       result_expr = ex<Constant>(0);
     return result_expr;
   }
 
+  /// @return true if count_contractions() produces the same count as
+  /// the enumeration of contractions by recursive_nontensor_wick()
+  bool can_count_contractions() const {
+    // topological pruning and the connectivity constraints of partial
+    // contractions depend on the order in which contractions are enumerated
+    return !use_topology_ && (full_contractions_ || nop_connections_.empty());
+  }
+
+  /// Counts the contractions of input_ by dynamic programming, without
+  /// enumerating them.
+
+  /// The Ops of a NormalOperator with the same action and Index space are
+  /// interchangeable, hence the number of ways to complete a set of
+  /// contractions only depends on how many Ops of each such class remain
+  /// uncontracted (and, if connectivity constraints are present, on which
+  /// NormalOperators are already connected); the counts are memoized for
+  /// each such state.
+  /// @return the number of full contractions if `full_contractions_==true`,
+  /// else the number of (partial and full) contractions plus 1 (the
+  /// contraction-free term)
+  /// @pre `can_count_contractions()==true`
+  std::size_t count_contractions() const {
+    assert(can_count_contractions());
+
+    // partition the Ops into classes; classes are ordered by NormalOperator
+    struct OpClass {
+      std::size_t nop_idx;
+      const Op<S> *op;  // representative Op
+      std::size_t size;
+    };
+    container::svector<OpClass> op_classes;
+    for (auto &&[nop_idx, nop] : ranges::views::enumerate(*input_)) {
+      const auto first_class_of_nop = op_classes.size();
+      for (auto &&op : nop) {
+        auto it = std::find_if(
+            op_classes.begin() + first_class_of_nop, op_classes.end(),
+            [&op](const OpClass &c) {
+              return c.op->action() == op.action() &&
+                     c.op->index().space() == op.index().space();
+            });
+        if (it == op_classes.end())
+          op_classes.push_back(
+              OpClass{static_cast<std::size_t>(nop_idx), &op, 1});
+        else
+          ++(it->size);
+      }
+    }
+    const auto nclasses = op_classes.size();
+    const auto nnops = input_->size();
+
+    // contractible[c1 * nclasses + c2] is true if an Op of class c1 can be
+    // contracted with a later Op of class c2
+    container::svector<bool> contractible(nclasses * nclasses, false);
+    for (std::size_t c1 = 0; c1 != nclasses; ++c1)
+      for (std::size_t c2 = c1 + 1; c2 != nclasses; ++c2)
+        contractible[c1 * nclasses + c2] =
+            op_classes[c1].nop_idx != op_classes[c2].nop_idx &&
+            can_contract(*op_classes[c1].op, *op_classes[c2].op,
+                         input_->vacuum());
+
+    // the state: # of uncontracted Ops in each class, followed by the
+    // nnops x nnops connectivity matrix of NormalOperators (if constrained)
+    const bool constrained = !nop_connections_.empty();
+    using state_type = container::svector<std::size_t>;
+    state_type state(nclasses + (constrained ? nnops * nnops : 0), 0);
+    for (std::size_t c = 0; c != nclasses; ++c) state[c] = op_classes[c].size;
+    auto connected = [&](state_type &st, std::size_t nop1, std::size_t nop2)
+        -> std::size_t & { return st[nclasses + nop1 * nnops + nop2]; };
+    // # of connections that are still needed by nop
+    auto nconnections_needed = [&](state_type &st, std::size_t nop) {
+      std::size_t result = 0;
+      for (std::size_t n = 0; n != nnops; ++n)
+        if (!nop_connections_[nop].test(n) && !connected(st, nop, n))
+          ++result;
+      return result;
+    };
+    // # of uncontracted Ops in nop
+    auto nops_uncontracted = [&](const state_type &st, std::size_t nop) {
+      std::size_t result = 0;
+      for (std::size_t c = 0; c != nclasses; ++c)
+        if (op_classes[c].nop_idx == nop) result += st[c];
+      return result;
+    };
+
+    std::map<state_type, std::size_t> memo;
+    // @return the number of ways to complete the contractions of state st
+    auto count = [&](auto &self, state_type &st) -> std::size_t {
+      // find the first class with uncontracted Ops
+      std::size_t c1 = 0;
+      while (c1 != nclasses && st[c1] == 0) ++c1;
+      if (c1 == nclasses) return 1;
+
+      if (auto it = memo.find(st); it != memo.end()) return it->second;
+
+      std::size_t result = 0;
+      // the first uncontracted Op (they are interchangeable) is either left
+      // uncontracted ...
+      --st[c1];
+      if (!full_contractions_) result += self(self, st);
+      // ... or contracted with an Op of a later class
+      const auto nop1 = op_classes[c1].nop_idx;
+      for (std::size_t c2 = c1 + 1; c2 != nclasses; ++c2) {
+        if (st[c2] == 0 || !contractible[c1 * nclasses + c2]) continue;
+        const auto multiplicity = st[c2];
+        --st[c2];
+        if (constrained) {
+          const auto nop2 = op_classes[c2].nop_idx;
+          const auto was_connected = connected(st, nop1, nop2);
+          connected(st, nop1, nop2) = connected(st, nop2, nop1) = 1;
+          // skip if the connectivity constraints can no longer be satisfied
+          if (nconnections_needed(st, nop1) <= nops_uncontracted(st, nop1) &&
+              nconnections_needed(st, nop2) <= nops_uncontracted(st, nop2))
+            result += multiplicity * self(self, st);
+          connected(st, nop1, nop2) = connected(st, nop2, nop1) =
+              was_connected;
+        } else
+          result += multiplicity * self(self, st);
+        ++st[c2];
+      }
+      ++st[c1];
+
+      memo.emplace(st, result);
+      return result;
+    };
+    return count(count, state);
+  }
+
  public:
   virtual ~WickTheorem();
 
  private:
-  void recursive_nontensor_wick(
-      std::pair<
-          std::vector<std::pair<Product, std::shared_ptr<NormalOperator<S>>>> *,
-          std::mutex *> &result,
-      NontensorWickState &state) const {
+  /// appends a contraction to @p result, or hands it to sink_, if nonnull
+  /// @param[in,out] result the buffer to which the contraction is appended
+  /// @param prefactor the prefactor of the contraction
+  /// @param nop the uncontracted operators, null if none
+  /// @note the caller is responsible for counting the term in the stats
+  void add_contraction(nontensor_wick_result_type &result, Product &&prefactor,
+                       std::shared_ptr<NormalOperator<S>> nop) const {
+    if (!sink_) {
+      result.emplace_back(std::move(prefactor), std::move(nop));
+      return;
+    }
+
+    ExprPtr term_expr = ex<Product>(std::move(prefactor));
+    if (nop) term_expr->as<Product>().append(1, std::move(nop));
+    // finalize the term as compute() would finalize the whole result
+    if (sink_prefactor_) {
+      term_expr = sink_prefactor_->clone() * term_expr;
+      expand(term_expr);
+      if (term_expr->is<Product>() || term_expr->is<Sum>())
+        this->reduce(term_expr);
+      rapid_simplify(term_expr);
+      canonicalize(term_expr);
+      rapid_simplify(term_expr);
+    }
+    if (term_expr->is<Constant>() && term_expr->as<Constant>().is_zero())
+      return;
+    std::scoped_lock<std::mutex> lock(*sink_mtx_);
+    sink_(std::move(term_expr));
+  }
+
+  /// @param[in,out] result the buffer to which the contractions are appended;
+  /// it is only accessed by the calling thread
+  /// @param[in,out] state the state of the recursion
+  template <typename State>
+  void recursive_nontensor_wick(nontensor_wick_result_type &result,
+                                State &state) const {
     using nopseq_view_type = flattened_rangenest<NormalOperatorSequence<S>>;
     auto nopseq_view = nopseq_view_type(&state.nopseq);
     using std::begin;
     using std::end;
 
+    ++state.num_visited_nodes;
+
     // if full contractions needed, make contractions involving first index with
     // another index, else contract any index i with index j (i<j)
     auto left_op_offset = state.left_op_offset;
@@ -1098,8 +1639,10 @@ class WickTheorem {
 
     // optimization: can't contract fully if first op is not a qp annihilator
     if (full_contractions_ &&
-        !is_qpannihilator(*op_left_iter, input_->vacuum()))
+        !is_qpannihilator(*op_left_iter, input_->vacuum())) {
+      ++state.num_pruned_branches;
       return;
+    }
 
     const auto op_left_iter_fence =
         full_contractions_ ? ranges::next(op_left_iter) : end(nopseq_view);
@@ -1188,7 +1731,7 @@ class WickTheorem {
                 if (use_op_partition_groups && is_unique &&
                     past_op_right_partition_idx < this->op_npartitions_) {
                   const auto left_partition_ncontr_past_right_partition =
-                      ranges::span<size_t>(
+                      ranges::span<const typename State::op_count_type>(
                           state.op_partition_cdeg_matrix.data() +
                               state.uptri_op(op_left_partition_idx,
                                              past_op_right_partition_idx),
@@ -1249,18 +1792,21 @@ class WickTheorem {
                   --nop_right_partition_idx;  // to 0-based
                   const auto &nop_right_partition =
                       state.nop_partitions.at(nop_right_partition_idx);
-                  if (!nop_right_partition.empty()) {  // ... and the partition
-                                                       // is not empty ...
-                    const auto it = nop_right_partition.find(nop_right_idx);
+                  if (nop_right_partition.any()) {  // ... and the partition
+                                                    // is not empty ...
                     // .. and not missing from the partition (because then it's
                     // topologically unique) ...
-                    if (it != nop_right_partition.end()) {
-                      // ... and first in the partition
-                      if (it == nop_right_partition.begin()) {
+                    if (nop_right_partition.test(nop_right_idx)) {
+                      // ... and first in the partition (i.e. no member
+                      // precedes it) ...
+                      if ((nop_right_partition &
+                           ~(~typename State::nop_partition_type{}
+                             << nop_right_idx))
+                              .none()) {
                         // account for the entire partition by scaling the
                         // contribution from the first contraction from this
                         // normal operator
-                        nop_topological_weight = nop_right_partition.size();
+                        nop_topological_weight = nop_right_partition.count();
                       } else
                         is_unique = false;
                     }
@@ -1311,8 +1857,7 @@ class WickTheorem {
           if (can_contract(*op_left_iter, *op_right_iter, input_->vacuum())) {
             auto &&[is_unique, nop_top_degen] = is_topologically_unique();
             if (is_unique) {
-              if (state.connect(nop_connections_,
-                                ranges::get_cursor(op_left_iter),
+              if (state.connect(ranges::get_cursor(op_left_iter),
                                 ranges::get_cursor(op_right_iter))) {
                 if (Logger::instance().wick_contract) {
                   std::wcout << "level " << state.level << ":contracting "
@@ -1342,7 +1887,10 @@ class WickTheorem {
                     contract(*op_left_iter, *op_right_iter, input_->vacuum()));
 
                 // update the stats
-                ++stats_.num_attempted_contractions;
+                ++state.num_attempted_contractions;
+
+                state.uncontracted_ops.reset(op_left_input_ordinal);
+                state.uncontracted_ops.reset(op_right_input_ordinal);
 
                 // remove from back to front
                 Op<S> right = *op_right_iter;
@@ -1386,17 +1934,14 @@ class WickTheorem {
                         auto prefactor = state.sp.deep_copy().scale(
                             std::move(scalar_prefactor));
 
-                        result.second->lock();
                         //              std::wcout << "got " <<
                         //              to_latex(state.sp)
                         //              << std::endl;
-                        result.first->push_back(std::make_pair(
-                            std::move(prefactor),
-                            std::shared_ptr<NormalOperator<S>>{}));
+                        ++state.num_terms;
+                        add_contraction(result, std::move(prefactor), {});
                         //              std::wcout << "now up to " <<
-                        //              result.first->size()
+                        //              result.size()
                         //              << " terms" << std::endl;
-                        result.second->unlock();
                       } else {
                         auto [target_partner_indices, ncycles] =
                             state.make_target_partner_indices();
@@ -1422,43 +1967,84 @@ class WickTheorem {
                         auto prefactor = state.sp.deep_copy().scale(
                             std::move(scalar_prefactor));
 
-                        result.second->lock();
-                        result.first->push_back(std::make_pair(
-                            std::move(prefactor),
-                            op->empty() ? nullptr : std::move(op)));
-                        result.second->unlock();
+                        ++state.num_terms;
+                        add_contraction(
+                            result, std::move(prefactor),
+                            op->empty() ? nullptr : std::move(op));
                       }
                     } else
                       ++state.count;
 
                     // update the stats: count this contraction as useful
-                    ++stats_.num_useful_contractions;
+                    ++state.num_useful_contractions;
                   }
                 }
 
-                if (state.nopseq_size != 0) {
-                  const auto current_num_useful_contractions =
-                      stats_.num_useful_contractions.load();
+                // if need full contractions skip the branches that cannot
+                // produce any
+                const bool prune = state.nopseq_size != 0 &&
+                                   full_contractions_ &&
+                                   !state.can_contract_fully();
+                if (prune) ++state.num_pruned_branches;
+                if (state.nopseq_size != 0 && !prune) {
                   ++state.level;
                   state.left_op_offset = left_op_offset;
-                  recursive_nontensor_wick(result, state);
-                  --state.level;
                   // this contraction is useful if it leads to useful
-                  // contractions as a result
-                  if (current_num_useful_contractions !=
-                      stats_.num_useful_contractions.load())
-                    ++stats_.num_useful_contractions;
+                  // contractions as a result; if tasks can be spawned below
+                  // it this is decided by a flag shared with them
+                  auto recurse = [this](auto &result, auto &state) {
+                    const bool flagged = state.tasks != nullptr &&
+                                         state.level < State::max_task_level;
+                    if (flagged)
+                      state.useful_flags.emplace_back(
+                          std::make_shared<std::atomic<bool>>(false));
+                    const auto current_num_useful_contractions =
+                        state.num_useful_contractions;
+                    recursive_nontensor_wick(result, state);
+                    const bool useful = current_num_useful_contractions !=
+                                        state.num_useful_contractions;
+                    if (flagged) {
+                      if (useful) state.mark_flagged_contractions_useful();
+                      state.useful_flags.pop_back();
+                    } else if (useful)
+                      ++state.num_useful_contractions;
+                  };
+                  if (state.spawn_task()) {
+                    // explore this branch using a copy of the state
+                    auto substate = std::make_shared<State>(state);
+                    state.tasks->run(
+                        [this, recurse, substate = std::move(substate)]() {
+                          nontensor_wick_result_type task_result;
+                          recurse(task_result, *substate);
+                          *(substate->root_count) += substate->count.load();
+                          if (substate->num_useful_contractions != 0)
+                            substate->mark_flagged_contractions_useful();
+                          substate->fold_stats();
+                          stats_.num_useful_contractions +=
+                              substate->num_useful_contractions;
+                          if (!task_result.empty()) {
+                            auto &task_results = *(substate->task_results);
+                            std::scoped_lock<std::mutex> lock(
+                                task_results.mtx);
+                            task_results.buffers.emplace_back(
+                                std::move(task_result));
+                          }
+                        });
+                  } else
+                    recurse(result, state);
+                  --state.level;
                 }
 
                 // restore the prefactor and nopseq
                 state.sp = std::move(sp_copy);
+                state.uncontracted_ops.set(op_left_input_ordinal);
+                state.uncontracted_ops.set(op_right_input_ordinal);
                 // restore from front to back
                 ranges::get_cursor(op_left_iter).insert(std::move(left));
                 ++state.nopseq_size;
                 ranges::get_cursor(op_right_iter).insert(std::move(right));
                 ++state.nopseq_size;
-                state.disconnect(nop_connections_,
-                                 ranges::get_cursor(op_left_iter),
+                state.disconnect(ranges::get_cursor(op_left_iter),
                                  ranges::get_cursor(op_right_iter));
                 //            std::wcout << "  restored nopseq = " <<
                 //            to_latex(state.opseq) << std::endl;
@@ -1517,11 +2103,12 @@ class WickTheorem {
           qpspace_common !=
               right.index().space()) {  // may need 2 overlaps if neither space
         // is pure qp creator/annihilator
-        auto result = std::make_shared<Product>();
-        result->append(1, left_is_ann
+        auto result = ex<Product>();
+        auto &product = result->as<Product>();
+        product.append(1, left_is_ann
                               ? make_overlap(left.index(), index_common)
                               : make_overlap(index_common, left.index()));
-        result->append(1, left_is_ann
+        product.append(1, left_is_ann
                               ? make_overlap(index_common, right.index())
                               : make_overlap(right.index(), index_common));
         return result;
@@ -1535,6 +2122,14 @@ class WickTheorem {
   /// @param[in,out] expr on input, Wick's theorem result, on output the result
   /// of reducing the overlaps
   void reduce(ExprPtr &expr) const;
+
+ private:
+  /// @param canonical_input the canonical form of the input Product
+  /// @return the key of the WickCache entry for @p canonical_input
+  std::wstring make_cache_key(const Product &canonical_input) const;
+
+  /// @return @p expr scaled by @p scalar , expanded
+  static ExprPtr scale(ExprPtr expr, const Product::scalar_type &scalar);
 };
 
 using BWickTheorem = WickTheorem<Statistics::BoseEinstein>;
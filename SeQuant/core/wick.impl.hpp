@@ -10,14 +10,20 @@
 
 #include <SeQuant/core/bliss.hpp>
 #include <SeQuant/core/logger.hpp>
+#include <SeQuant/core/parse.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
+// N.B. TensorNetwork is also used to compute the keys of WickCache
+#include <SeQuant/core/tensor_network.hpp>
 #if USE_TENSOR_NETWORK_V2
 #include <SeQuant/core/tensor_network_v2.hpp>
-#else
-#include <SeQuant/core/tensor_network.hpp>
 #endif
 #include <SeQuant/core/tensor_network/vertex.hpp>
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+
 #ifdef SEQUANT_HAS_EXECUTION_HEADER
 #include <execution>
 #endif
@@ -28,6 +34,37 @@ namespace detail {
 
 struct zero_result : public std::exception {};
 
+/// @brief memoizes IndexSpaceRegistry::intersection
+
+/// The reduction of a product intersects the same few pairs of spaces over and
+/// over; this caches the intersections in a flat table keyed by the integer
+/// attributes of the spaces.
+/// @note the registry must not change during the lifetime of this object
+class SpaceIntersectionCache {
+ public:
+  explicit SpaceIntersectionCache(
+      std::shared_ptr<const IndexSpaceRegistry> isr)
+      : isr_(std::move(isr)) {}
+
+  /// @return `isr->intersection(space1, space2)`
+  const IndexSpace &operator()(const IndexSpace &space1,
+                               const IndexSpace &space2) {
+    if (space1 == space2) return space1;
+    const key_type key{space1.type().to_int32(), space1.qns().to_int32(),
+                       space2.type().to_int32(), space2.qns().to_int32()};
+    for (auto &&[k, v] : entries_)
+      if (k == key) return *v;
+    const auto &result = isr_->intersection(space1, space2);
+    entries_.emplace_back(key, &result);
+    return result;
+  }
+
+ private:
+  using key_type = std::array<std::int32_t, 4>;
+  std::shared_ptr<const IndexSpaceRegistry> isr_;
+  container::svector<std::pair<key_type, const IndexSpace *>, 16> entries_;
+};
+
 /// @brief computes index replacement rules
 
 /// If using orthonormal representation, overlaps are Kronecker deltas, hence
@@ -40,13 +77,19 @@ struct zero_result : public std::exception {};
 ///   - if space of J includes space of I, replace J with I, !!remove delta!!
 ///   - if space of J is a subset of space of I, replace J with a new internal
 ///     index representing intersection of spaces of I and J, !!keep the delta!!
+/// @return the replacement rules, as a map from the replaced indices to
+///         their replacements
 /// @throw zero_result if @c product is zero for any reason, e.g. because
 ///        it includes an overlap of 2 indices from nonoverlapping spaces
+/// @note the dense ids of the overlap indices are only used internally, to
+///       build the rules; the result is keyed by Index, as required by
+///       apply_index_replacement_rules() and Tensor::transform_indices()
 template <Statistics S>
 container::map<Index, Index> compute_index_replacement_rules(
     std::shared_ptr<Product> &product,
     const container::set<Index> &external_indices,
-    const std::set<Index, Index::LabelCompare> &all_indices) {
+    const std::set<Index, Index::LabelCompare> &all_indices,
+    SpaceIntersectionCache &intersection) {
   expr_range exrng(product);
 
   /// this ensures that all temporary indices have unique *labels* (not just
@@ -55,13 +98,28 @@ container::map<Index, Index> compute_index_replacement_rules(
     return all_indices.find(idx) == all_indices.end();
   };
   IndexFactory idxfac(index_validator);
-  container::map<Index /* src */, Index /* dst */> result;  // src->dst
+
+  // the rules are built using dense ids of the overlap indices:
+  // indices[id] is the index, dsts[id] is its replacement (if any);
+  // N.B. the id of an index is found by a linear search, which is cheap since
+  // a product only has a few overlaps
+  container::svector<Index, 16> indices;
+  container::svector<std::optional<Index>, 16> dsts;
+  container::svector<bool, 16> is_ext;
+  auto id = [&](const Index &idx) -> std::size_t {
+    const auto it = ranges::find(indices, idx);
+    if (it != indices.end()) return it - indices.begin();
+    indices.push_back(idx);
+    dsts.emplace_back();
+    is_ext.push_back(external_indices.contains(idx));
+    return indices.size() - 1;
+  };
 
   // computes an index in intersection of space1 and space2
-  auto make_intersection_index = [&idxfac](const IndexSpace &space1,
-                                           const IndexSpace &space2) {
-    auto isr = sequant::get_default_context(S).index_space_registry();
-    const auto intersection_space = isr->intersection(space1, space2);
+  auto make_intersection_index = [&idxfac, &intersection](
+                                     const IndexSpace &space1,
+                                     const IndexSpace &space2) {
+    const auto &intersection_space = intersection(space1, space2);
     if (!intersection_space) throw zero_result{};
     return idxfac.make(intersection_space);
   };
@@ -81,18 +139,18 @@ container::map<Index, Index> compute_index_replacement_rules(
   };
 
   // adds src->dst or src->intersection(dst,current_dst)
-  auto add_rule = [&result, &proto, &make_intersection_index](
-                      const Index &src, const Index &dst) {
-    auto src_it = result.find(src);
-    if (src_it == result.end()) {  // if brand new, add the rule
-      auto insertion_result = result.emplace(src, proto(dst, src));
-      assert(insertion_result.second);
+  auto add_rule = [&indices, &dsts, &proto, &make_intersection_index](
+                      std::size_t src_id, const Index &dst) {
+    const auto &src = indices[src_id];
+    auto &src_dst = dsts[src_id];
+    if (!src_dst) {  // if brand new, add the rule
+      src_dst = proto(dst, src);
     } else {  // else modify the destination of the existing rule to the
       // intersection
-      const auto &old_dst = src_it->second;
+      const auto &old_dst = *src_dst;
       assert(old_dst.proto_indices() == src.proto_indices());
       if (dst.space() != old_dst.space()) {
-        src_it->second =
+        src_dst =
             proto(make_intersection_index(old_dst.space(), dst.space()), src);
       }
     }
@@ -101,14 +159,16 @@ container::map<Index, Index> compute_index_replacement_rules(
   // adds src1->dst and src2->dst; if src1->dst1 and/or src2->dst2 already
   // exist the existing rules are updated to map to the intersection of dst1,
   // dst2 and dst
-  auto add_rules = [&result, &idxfac, &proto, &make_intersection_index](
-                       const Index &src1, const Index &src2, const Index &dst) {
-    auto isr = get_default_context(S).index_space_registry();
+  auto add_rules = [&indices, &dsts, &idxfac, &proto, &make_intersection_index,
+                    &intersection](std::size_t src1_id, std::size_t src2_id,
+                                   const Index &dst) {
+    const auto &src1 = indices[src1_id];
+    const auto &src2 = indices[src2_id];
+    auto &src1_dst = dsts[src1_id];
+    auto &src2_dst = dsts[src2_id];
     // are there replacement rules already for src{1,2}?
-    auto src1_it = result.find(src1);
-    auto src2_it = result.find(src2);
-    const auto has_src1_rule = src1_it != result.end();
-    const auto has_src2_rule = src2_it != result.end();
+    const auto has_src1_rule = src1_dst.has_value();
+    const auto has_src2_rule = src2_dst.has_value();
 
     // which proto-indices should dst1 and dst2 inherit? a source index without
     // proto indices will inherit its source counterpart's indices, unless it
@@ -121,62 +181,45 @@ container::map<Index, Index> compute_index_replacement_rules(
         !src2.has_proto_indices() && src1.has_proto_indices() ? src1 : src2;
 
     if (!has_src1_rule && !has_src2_rule) {  // if brand new, add the rules
-      auto insertion_result1 = result.emplace(src1, proto(dst, dst1_proto));
-      assert(insertion_result1.second);
-      auto insertion_result2 = result.emplace(src2, proto(dst, dst2_proto));
-      assert(insertion_result2.second);
+      src1_dst = proto(dst, dst1_proto);
+      src2_dst = proto(dst, dst2_proto);
     } else if (has_src1_rule &&
                !has_src2_rule) {  // update the existing rule for src1
-      const auto &old_dst1 = src1_it->second;
+      const auto &old_dst1 = *src1_dst;
       assert(old_dst1.proto_indices() == dst1_proto.proto_indices());
       if (dst.space() != old_dst1.space()) {
-        src1_it->second = proto(
-            make_intersection_index(old_dst1.space(), dst.space()), dst1_proto);
+        src1_dst = proto(make_intersection_index(old_dst1.space(), dst.space()),
+                         dst1_proto);
       }
-      result.emplace(src2, src1_it->second);
+      src2_dst = *src1_dst;
     } else if (!has_src1_rule &&
                has_src2_rule) {  // update the existing rule for src2
-      const auto &old_dst2 = src2_it->second;
+      const auto &old_dst2 = *src2_dst;
       assert(old_dst2.proto_indices() == dst2_proto.proto_indices());
       if (dst.space() != old_dst2.space()) {
-        src2_it->second = proto(
-            make_intersection_index(old_dst2.space(), dst.space()), dst2_proto);
+        src2_dst = proto(make_intersection_index(old_dst2.space(), dst.space()),
+                         dst2_proto);
       }
-      result.emplace(src1, src2_it->second);
-    } else {  // update both of the existing rules
-      const auto &old_dst1 = src1_it->second;
-      const auto &old_dst2 = src2_it->second;
-      const auto new_dst_space =
+      src1_dst = *src2_dst;
+    } else {  // both rules exist
+      // N.B. the existing rules are kept, only check that the
+      // destinations overlap
+      const auto &old_dst1 = *src1_dst;
+      const auto &old_dst2 = *src2_dst;
+      const auto &new_dst_space =
           (dst.space() != old_dst1.space() || dst.space() != old_dst2.space())
-              ? isr->intersection(
-                    isr->intersection(old_dst1.space(), old_dst2.space()),
-                    dst.space())
+              ? intersection(intersection(old_dst1.space(), old_dst2.space()),
+                             dst.space())
               : dst.space();
       if (!new_dst_space) throw zero_result{};
-      Index new_dst;
-      if (new_dst_space == old_dst1.space()) {
-        new_dst = old_dst1;
-        if (new_dst_space == old_dst2.space() && old_dst2 < new_dst) {
-          new_dst = old_dst2;
-        }
-        if (new_dst_space == dst.space() && dst < new_dst) {
-          new_dst = dst;
-        }
-      } else if (new_dst_space == old_dst2.space()) {
-        new_dst = old_dst2;
-        if (new_dst_space == dst.space() && dst < new_dst) {
-          new_dst = dst;
-        }
-      } else if (new_dst_space == dst.space()) {
-        new_dst = dst;
-      } else
-        new_dst = idxfac.make(new_dst_space);
-      result.emplace(src1, proto(new_dst, dst1_proto));
-      result.emplace(src2, proto(new_dst, dst2_proto));
+      // consume a label as a new destination would, to keep the labels of
+      // the subsequently made indices unchanged
+      if (new_dst_space != old_dst1.space() &&
+          new_dst_space != old_dst2.space() && new_dst_space != dst.space())
+        idxfac.make(new_dst_space);
     }
   };
 
-  auto isr = get_default_context(S).index_space_registry();
   /// this makes the list of replacements ... we do not mutate the expressions
   /// to keep the information about which indices are related
   for (auto it = ranges::begin(exrng); it != ranges::end(exrng); ++it) {
@@ -190,13 +233,13 @@ container::map<Index, Index> compute_index_replacement_rules(
         const auto &ket = tensor.ket().at(0);
         assert(bra != ket);
 
-        const auto bra_is_ext = ranges::find(external_indices, bra) !=
-                                ranges::end(external_indices);
-        const auto ket_is_ext = ranges::find(external_indices, ket) !=
-                                ranges::end(external_indices);
+        const auto bra_id = id(bra);
+        const auto ket_id = id(ket);
+        const auto bra_is_ext = is_ext[bra_id];
+        const auto ket_is_ext = is_ext[ket_id];
 
-        const auto intersection_space =
-            isr->intersection(bra.space(), ket.space());
+        const auto &intersection_space =
+            intersection(bra.space(), ket.space());
 
         // if overlap's indices are from non-overlapping spaces, return zero
         if (!intersection_space) {
@@ -205,34 +248,50 @@ container::map<Index, Index> compute_index_replacement_rules(
 
         if (!bra_is_ext && !ket_is_ext) {  // int + int
           const auto new_dummy = idxfac.make(intersection_space);
-          add_rules(bra, ket, new_dummy);
+          add_rules(bra_id, ket_id, new_dummy);
         } else if (bra_is_ext && !ket_is_ext) {  // ext + int
           if (includes(ket.space(), bra.space())) {
-            add_rule(ket, bra);
+            add_rule(ket_id, bra);
           } else {
-            add_rule(ket, idxfac.make(intersection_space));
+            add_rule(ket_id, idxfac.make(intersection_space));
           }
         } else if (!bra_is_ext && ket_is_ext) {  // int + ext
           if (includes(bra.space(), ket.space())) {
-            add_rule(bra, ket);
+            add_rule(bra_id, ket);
           } else {
-            add_rule(bra, idxfac.make(intersection_space));
+            add_rule(bra_id, idxfac.make(intersection_space));
           }
         }
       }
     }
   }
 
+  // convert to a map
+  container::svector<std::pair<Index, Index>, 16> rules;
+  for (std::size_t i = 0; i != indices.size(); ++i) {
+    if (dsts[i]) rules.emplace_back(std::move(indices[i]), std::move(*dsts[i]));
+  }
+  ranges::sort(rules, [](const auto &a, const auto &b) {
+    return a.first < b.first;
+  });
+  container::map<Index /* src */, Index /* dst */> result;  // src->dst
+  result.insert(boost::container::ordered_unique_range,
+                std::make_move_iterator(rules.begin()),
+                std::make_move_iterator(rules.end()));
   return result;
 }
 
+/// @param const_replrules the rules computed by
+///        compute_index_replacement_rules()
 /// @return true if made any changes
+/// @note operates on Index objects, i.e. does not use the ids of the indices
+///       used by compute_index_replacement_rules()
 inline bool apply_index_replacement_rules(
     std::shared_ptr<Product> &product,
     const container::map<Index, Index> &const_replrules,
     const container::set<Index> &external_indices,
     std::set<Index, Index::LabelCompare> &all_indices,
-    const std::shared_ptr<const IndexSpaceRegistry> &isr) {
+    SpaceIntersectionCache &intersection) {
   // to be able to use map[]
   auto &replrules = const_cast<container::map<Index, Index> &>(const_replrules);
 
@@ -273,14 +332,12 @@ inline bool apply_index_replacement_rules(
           const auto &ket = tensor.ket().at(0);
 
           if (bra.proto_indices() == ket.proto_indices()) {
-            const auto bra_is_ext = ranges::find(external_indices, bra) !=
-                                    ranges::end(external_indices);
-            const auto ket_is_ext = ranges::find(external_indices, ket) !=
-                                    ranges::end(external_indices);
+            const auto bra_is_ext = external_indices.contains(bra);
+            const auto ket_is_ext = external_indices.contains(ket);
 
 #ifndef NDEBUG
             const auto intersection_space =
-                isr->intersection(bra.space(), ket.space());
+                intersection(bra.space(), ket.space());
 #endif
 
             if (!bra_is_ext && !ket_is_ext) {  // int + int
@@ -291,8 +348,7 @@ inline bool apply_index_replacement_rules(
 #endif
               erase_it = true;
             } else if (bra_is_ext && !ket_is_ext) {  // ext + int
-              if (isr->intersection(ket.space(), bra.space()) !=
-                  IndexSpace::null) {
+              if (intersection(ket.space(), bra.space()) != IndexSpace::null) {
 #ifndef NDEBUG
                 if (replrules.find(ket) != replrules.end())
                   assert(replrules[ket].space() == bra.space());
@@ -305,8 +361,7 @@ inline bool apply_index_replacement_rules(
 #endif
               }
             } else if (!bra_is_ext && ket_is_ext) {  // int + ext
-              if (isr->intersection(bra.space(), ket.space()) !=
-                  IndexSpace::null) {
+              if (intersection(bra.space(), ket.space()) != IndexSpace::null) {
 #ifndef NDEBUG
                 if (replrules.find(bra) != replrules.end())
                   assert(replrules[bra].space() == ket.space());
@@ -357,6 +412,19 @@ inline bool apply_index_replacement_rules(
   return mutated;
 }
 
+/// @return true if made any changes
+inline bool apply_index_replacement_rules(
+    std::shared_ptr<Product> &product,
+    const container::map<Index, Index> &const_replrules,
+    const container::set<Index> &external_indices,
+    std::set<Index, Index::LabelCompare> &all_indices,
+    const std::shared_ptr<const IndexSpaceRegistry> &isr) {
+  SpaceIntersectionCache intersection(isr);
+  return apply_index_replacement_rules(product, const_replrules,
+                                       external_indices, all_indices,
+                                       intersection);
+}
+
 /// If using orthonormal representation, resolves Kronecker deltas (=overlaps
 /// between indices in orthonormal spaces) in summations
 /// @throw zero_result if @c expr is zero
@@ -364,6 +432,8 @@ template <Statistics S>
 void reduce_wick_impl(std::shared_ptr<Product> &expr,
                       const container::set<Index> &external_indices) {
   if (get_default_context(S).metric() == IndexSpaceMetric::Unit) {
+    SpaceIntersectionCache intersection(
+        get_default_context(S).index_space_registry());
     bool pass_mutated = false;
     do {
       pass_mutated = false;
@@ -381,7 +451,7 @@ void reduce_wick_impl(std::shared_ptr<Product> &expr,
       });
 
       const auto replacement_rules = compute_index_replacement_rules<S>(
-          expr, external_indices, all_indices);
+          expr, external_indices, all_indices, intersection);
 
       if (Logger::instance().wick_reduce) {
         std::wcout << "reduce_wick_impl(expr, external_indices):\n  expr = "
@@ -398,9 +468,9 @@ void reduce_wick_impl(std::shared_ptr<Product> &expr,
       }
 
       if (!replacement_rules.empty()) {
-        auto isr = get_default_context(S).index_space_registry();
         pass_mutated = apply_index_replacement_rules(
-            expr, replacement_rules, external_indices, all_indices, isr);
+            expr, replacement_rules, external_indices, all_indices,
+            intersection);
       }
 
       if (Logger::instance().wick_reduce) {
@@ -412,6 +482,59 @@ void reduce_wick_impl(std::shared_ptr<Product> &expr,
     abort();  // programming error?
 }
 
+/// @param replacements a bijective map between two sets of indices
+/// @return the permutation of the union of the keys and values of
+/// @p replacements that agrees with it on its keys; the values that are not
+/// keys are mapped onto the keys that are not values, in the same space
+/// @note applying the result to an expression (see relabel()) hence renames
+/// its indices without merging any
+inline container::map<Index, Index> complete_to_permutation(
+    const container::map<Index, Index> &replacements) {
+  container::set<Index> targets;
+  for (auto &&[source, target] : replacements) targets.emplace(target);
+  // the indices that are replaced but are not replacements, by space
+  container::multimap<IndexSpace, Index> vacated;
+  for (auto &&[source, target] : replacements) {
+    if (!targets.contains(source)) vacated.emplace(source.space(), source);
+  }
+  container::map<Index, Index> result(replacements);
+  for (auto &&target : targets) {
+    if (replacements.contains(target)) continue;
+    auto it = vacated.find(target.space());
+    assert(it != vacated.end());
+    result.emplace(target, it->second);
+    vacated.erase(it);
+  }
+  return result;
+}
+
+/// @param expr an expression
+/// @param replacements the index replacements; must be a permutation (see
+/// complete_to_permutation()) unless the replaced indices do not occur in
+/// @p expr
+/// @return a copy of @p expr with the indices replaced according to
+/// @p replacements
+inline ExprPtr relabel(const ExprPtr &expr,
+                       const container::map<Index, Index> &replacements) {
+  // N.B. the hash values of the (new) composite subexpressions of the clone
+  // have not been computed, hence need not be reset
+  auto result = expr->clone();
+  if (replacements.empty()) return result;
+  auto relabel_tensor = [&replacements](const ExprPtr &subexpr) {
+    if (auto tensor = std::dynamic_pointer_cast<AbstractTensor>(subexpr)) {
+      transform_indices(*tensor, replacements);
+      reset_tags(*tensor);
+    }
+  };
+  if (result->is_atom())
+    relabel_tensor(result);
+  else
+    result->visit(
+        [&relabel_tensor](ExprPtr &subexpr) { relabel_tensor(subexpr); },
+        /* atoms_only = */ true);
+  return result;
+}
+
 template <Statistics S>
 struct NullNormalOperatorCanonicalizerDeregister {
   void operator()(void *) {
@@ -494,6 +617,7 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
     if (expr_input_->is<Sum>()) {
       if (!skip_input_canonicalization) {
         // initial full canonicalization
+        auto timer = stats_.time(Stats::Phase::canonicalize_input);
         canonicalize(expr_input_);
         assert(!expr_input_->as<Sum>().empty());
       }
@@ -504,8 +628,8 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
       disable_nop_canonicalization();
 
       // parallelize over summands
-      auto result = std::make_shared<Sum>();
-      std::mutex result_mtx;  // serializes updates of result
+      ExprPtr result_expr = ex<Sum>();
+      auto &result = result_expr->as<Sum>();
       auto summands = expr_input_->as<Sum>().summands();
 
       // find external_indices if don't have them
@@ -527,30 +651,32 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
 
       if (Logger::instance().wick_harness)
         std::wcout << "WickTheorem<S>::compute: input (after canonicalize) has "
-                   << summands.size() << " terms = " << to_latex_align(result)
-                   << std::endl;
-
-      auto wick_task = [&result, &result_mtx, this,
-                        &count_only](const ExprPtr &input) {
-        WickTheorem wt(input->clone(), *this);
+                   << summands.size()
+                   << " terms = " << to_latex_align(result_expr) << std::endl;
+
+      // each task writes the result into its own slot, the slots are merged
+      // into the result once all tasks are done
+      std::vector<ExprPtr> task_results(summands.size());
+      auto wick_task = [&summands, &task_results, this,
+                        &count_only](std::size_t task_id) {
+        WickTheorem wt(summands[task_id]->clone(), *this);
         auto task_result = wt.compute(
             count_only, /* definitely skip input canonicalization */ true);
         stats() += wt.stats();
-        if (task_result) {
-          std::scoped_lock<std::mutex> lock(result_mtx);
-          result->append(task_result);
-        }
+        task_results[task_id] = std::move(task_result);
       };
-      sequant::for_each(summands, wick_task);
+      auto task_ids = ranges::views::iota(std::size_t{0}, summands.size());
+      sequant::for_each(task_ids, wick_task);
+      for (auto &task_result : task_results) {
+        if (task_result) result.append(std::move(task_result));
+      }
 
       // if the sum is empty return zero
       // if the sum has 1 summand, return it directly
-      ExprPtr result_expr = result;
-      if (result->summands().size() == 0) {
+      if (result.summands().size() == 0) {
         result_expr = ex<Constant>(0);
-      }
-      if (result->summands().size() == 1)
-        result_expr = std::move(result->summands()[0]);
+      } else if (result.summands().size() == 1)
+        result_expr = result.summands()[0];
 
       return result_expr;
     }
@@ -583,9 +709,68 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
           [](const ExprPtr &expr) { return expr->is<NormalOperator<S>>(); });
       // if have ops, split into nop sequence and cnumber "prefactor"
       if (first_nop_it != ranges::end(*expr_input_)) {
-        // extract into prefactor and op sequence
-        ExprPtr prefactor =
-            ex<CProduct>(expr_input_->as<Product>().scalar(), ExprPtrList{});
+        // if memoizing, the cache holds the result for the canonical form of
+        // the input with unit scalar; the named indices (external_indices_)
+        // keep their labels, the dummy indices are canonically relabeled.
+        // The input itself is not modified: the result for it is obtained by
+        // relabeling the canonical result back onto its indices and scaling.
+        // If told to skip canonicalization the input is used as is, hence
+        // only the inputs with identical dummy labels share the cache entry.
+        const auto all_factors_are_tensors =
+            ranges::all_of(*expr_input_, [](const ExprPtr &factor) {
+              return std::dynamic_pointer_cast<AbstractTensor>(factor) !=
+                     nullptr;
+            });
+        const auto cache = count_only || sink_ || !all_factors_are_tensors
+                               ? nullptr
+                               : WickCache::instance();
+        std::wstring cache_key;
+        // maps the indices of the input to those of its canonical form
+        container::map<Index, Index> to_canonical_indices;
+        // the input with unit scalar = canonicalization_byproduct * (its
+        // canonical form relabeled by to_canonical_indices^{-1})
+        Product::scalar_type canonicalization_byproduct = 1;
+        if (cache) {
+          auto timer = stats_.time(Stats::Phase::canonicalize_input);
+          auto input_copy = expr_input_->clone();
+          TensorNetwork tn(input_copy->as<Product>().factors());
+          if (!skip_input_canonicalization) {
+            TensorNetwork::named_indices_t named_indices = tn.ext_indices();
+            named_indices.insert(external_indices_->begin(),
+                                 external_indices_->end());
+            auto byproduct =
+                tn.canonicalize(TensorCanonicalizer::cardinal_tensor_labels(),
+                                /* fast = */ false, &named_indices);
+            if (byproduct)
+              canonicalization_byproduct = byproduct->as<Constant>().value();
+            to_canonical_indices =
+                detail::complete_to_permutation(tn.idxrepl());
+          }
+          auto canonical_input = ex<Product>(
+              1,
+              tn.tensors() | ranges::views::transform([](const auto &tensor) {
+                return std::dynamic_pointer_cast<Expr>(tensor);
+              }) | ranges::to<ExprPtrVector>,
+              Product::Flatten::No);
+          cache_key = make_cache_key(canonical_input->as<Product>());
+
+          if (auto cached_result = cache->find(cache_key)) {
+            ++stats_.num_cache_hits;
+            container::map<Index, Index> from_canonical_indices;
+            for (auto &&[from, to] : to_canonical_indices)
+              from_canonical_indices.emplace(to, from);
+            return scale(detail::relabel(cached_result, from_canonical_indices),
+                         expr_input_->as<Product>().scalar() *
+                             canonicalization_byproduct);
+          }
+        }
+
+        // extract into prefactor and op sequence; if memoizing the result is
+        // computed with unit scalar, and scaled after it has been cached
+        ExprPtr prefactor = ex<CProduct>(
+            cache ? Product::scalar_type{1}
+                  : expr_input_->as<Product>().scalar(),
+            ExprPtrList{});
         auto nopseq = std::make_shared<NormalOperatorSequence<S>>();
         for (const auto &factor : *expr_input_) {
           if (factor->template is<NormalOperator<S>>()) {
@@ -600,6 +785,7 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
         // compute and record/analyze topological NormalOperator and Index
         // partitions
         if (use_topology_) {
+          auto timer = stats_.time(Stats::Phase::topology);
           if (Logger::instance().wick_topology)
             std::wcout
                 << "WickTheorem<S>::compute: input to topology computation = "
@@ -1001,18 +1187,32 @@ ExprPtr WickTheorem<S>::compute(const bool count_only,
             for (auto &&nop : input_) std::wcout << to_latex(nop) << "\n";
             std::wcout << "}" << std::endl;
           }
+          // the terms handed to the sink are finalized individually
+          if (sink_) sink_prefactor_ = prefactor;
           auto result = compute_nopseq(count_only);
           if (result) {  // simplify if obtained nonzero ...
-            result = prefactor * result;
-            expand(result);
-            this->reduce(result);
-            rapid_simplify(result);
+            {
+              auto timer = stats_.time(Stats::Phase::reduce);
+              result = prefactor * result;
+              expand(result);
+              this->reduce(result);
+              rapid_simplify(result);
+            }
+            auto timer = stats_.time(Stats::Phase::canonicalize_result);
             canonicalize(result);
             rapid_simplify(
                 result);  // rapid_simplify again since canonization may produce
                           // new opportunities (e.g. terms cancel, etc.)
           } else
             result = ex<Constant>(0);
+          if (cache) {
+            cache->insert(cache_key,
+                          scale(detail::relabel(result, to_canonical_indices),
+                                Product::scalar_type{1} /
+                                    canonicalization_byproduct));
+            result =
+                scale(std::move(result), expr_input_->as<Product>().scalar());
+          }
           return result;
         }
       } else {  // product does not include ops
@@ -1072,6 +1272,49 @@ void WickTheorem<S>::reduce(ExprPtr &expr) const {
                << to_latex_align(expr, 20, 1) << std::endl;
   }
 }
+template <Statistics S>
+std::wstring WickTheorem<S>::make_cache_key(
+    const Product &canonical_input) const {
+  const auto &ctx = get_default_context(S);
+  std::wostringstream oss;
+  oss << L"S=" << static_cast<int>(S)
+      << L";vacuum=" << static_cast<int>(ctx.vacuum())
+      << L";metric=" << static_cast<int>(ctx.metric())
+      << L";spbasis=" << static_cast<int>(ctx.spbasis())
+      << L";full=" << full_contractions_ << L";topology=" << use_topology_
+      << L";spaces={";
+  // the registry determines the occupancies of the spaces, hence the result
+  if (const auto isr = ctx.index_space_registry()) {
+    for (auto &&space : *isr->spaces())
+      oss << space.base_key() << L":" << space.type().to_int32() << L":"
+          << space.qns().to_int32() << L",";
+    oss << L"vacocc:" << isr->vacuum_occupied_space(true).to_int32()
+        << L",refocc:" << isr->reference_occupied_space(true).to_int32()
+        << L",complete:" << isr->complete_space(true).to_int32();
+  }
+  oss << L"};ext={";
+  if (external_indices_) {
+    for (auto &&idx : *external_indices_) oss << deparse(idx) << L",";
+  }
+  oss << L"};connections={";
+  for (auto &&[nop1, nop2] : nop_connections_input_)
+    oss << nop1 << L"-" << nop2 << L",";
+  for (auto &&connections : nop_connections_)
+    oss << sequant::to_wstring(connections.to_string()) << L",";
+  oss << L"};" << deparse(canonical_input, /* annot_sym = */ true);
+  return oss.str();
+}
+
+template <Statistics S>
+ExprPtr WickTheorem<S>::scale(ExprPtr expr,
+                              const Product::scalar_type &scalar) {
+  if (scalar == Product::scalar_type{1}) return expr;
+  expr = ex<Constant>(scalar) * expr;
+  expand(expr);
+  rapid_simplify(expr);
+  return expr;
+}
+
 template <Statistics S>
 WickTheorem<S>::~WickTheorem() {}
 
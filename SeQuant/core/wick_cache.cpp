@@ -0,0 +1,90 @@
+#include <SeQuant/core/wick_cache.hpp>
+
+#include <SeQuant/core/parse.hpp>
+#include <SeQuant/core/utility/atomic_shared_ptr.hpp>
+#include <SeQuant/core/utility/string.hpp>
+
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+namespace sequant {
+
+namespace {
+// N.B. queried by every WickTheorem::compute, hence lock-free
+AtomicSharedPtr<WickCache> &instance_accessor() {
+  static AtomicSharedPtr<WickCache> instance;
+  return instance;
+}
+}  // namespace
+
+std::shared_ptr<WickCache> WickCache::instance() {
+  return instance_accessor().load();
+}
+
+void WickCache::set_instance(std::shared_ptr<WickCache> cache) {
+  instance_accessor().store(std::move(cache));
+}
+
+ExprPtr WickCache::find(const std::wstring &key) const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++nmisses_;
+    return {};
+  }
+  ++nhits_;
+  return it->second->clone();
+}
+
+void WickCache::insert(const std::wstring &key, const ExprPtr &value) {
+  assert(value);
+  auto value_copy = value->clone();
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  entries_.emplace(key, std::move(value_copy));
+}
+
+std::size_t WickCache::size() const {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return entries_.size();
+}
+
+void WickCache::clear() {
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  entries_.clear();
+  nhits_ = 0;
+  nmisses_ = 0;
+}
+
+void WickCache::save(const std::filesystem::path &path) const {
+  std::ofstream file(path);
+  if (!file)
+    throw std::runtime_error("WickCache::save: could not open " +
+                             path.string());
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  for (const auto &[key, value] : entries_) {
+    // N.B. only c-numbers are guaranteed to be parsable
+    if (!value->is_cnumber()) continue;
+    file << toUtf8(key) << '\n' << toUtf8(deparse(value)) << '\n';
+  }
+  if (!file)
+    throw std::runtime_error("WickCache::save: could not write to " +
+                             path.string());
+}
+
+void WickCache::load(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  if (!file)
+    throw std::runtime_error("WickCache::load: could not open " +
+                             path.string());
+  std::string key;
+  std::string value;
+  while (std::getline(file, key) && std::getline(file, value)) {
+    insert(toUtf16(key), parse_expr(toUtf16(value)));
+  }
+  if (file.bad())
+    throw std::runtime_error("WickCache::load: could not read from " +
+                             path.string());
+}
+
+}  // namespace sequant
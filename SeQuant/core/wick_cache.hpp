@@ -0,0 +1,94 @@
+#ifndef SEQUANT_CORE_WICK_CACHE_HPP
+#define SEQUANT_CORE_WICK_CACHE_HPP
+
+#include <SeQuant/core/expr.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace sequant {
+
+// clang-format off
+/// @brief Memoizes the results of WickTheorem::compute
+
+/// WickTheorem::compute applied to a Product looks up its result in the
+/// cache returned by WickCache::instance() (if any). The cache is keyed by the
+/// canonical form of the input (i.e. obtained by the tensor network
+/// canonicalization via bliss, with unit scalar prefactor, keeping the labels
+/// of the external indices) and the parameters of the computation (external
+/// indices, connectivity constraints, use of topology, vacuum, the index
+/// spaces of the default context, etc.), hence inputs that only differ by the
+/// labels of the dummy indices and/or by the scalar prefactor share the cache
+/// entry. The cached result is relabeled onto the dummy indices of the input
+/// and scaled by its prefactor.
+///
+/// Caching is opt-in:
+/// \code
+/// WickCache::set_instance(std::make_shared<WickCache>());
+/// \endcode
+/// The contents of the cache can be persisted to disk via save() and
+/// load().
+// clang-format on
+class WickCache {
+ public:
+  WickCache() = default;
+
+  WickCache(const WickCache &) = delete;
+  WickCache &operator=(const WickCache &) = delete;
+
+  /// @return the cache used by WickTheorem::compute; null (the default) means
+  /// caching is disabled
+  static std::shared_ptr<WickCache> instance();
+
+  /// installs @p cache as the cache used by WickTheorem::compute
+  /// @param cache the cache to use; null disables caching
+  static void set_instance(std::shared_ptr<WickCache> cache);
+
+  /// @param key the key
+  /// @return a copy of the value associated with @p key, or null if not found
+  ExprPtr find(const std::wstring &key) const;
+
+  /// associates @p value with @p key, unless already present
+  /// @param key the key
+  /// @param value the value; the cache keeps a copy
+  void insert(const std::wstring &key, const ExprPtr &value);
+
+  /// @return the number of entries in the cache
+  std::size_t size() const;
+
+  /// removes all entries and resets the hit/miss counters
+  void clear();
+
+  /// @return the number of find() calls that found the key
+  std::size_t nhits() const { return nhits_.load(); }
+
+  /// @return the number of find() calls that did not find the key
+  std::size_t nmisses() const { return nmisses_.load(); }
+
+  /// writes the entries that are c-numbers (i.e. results of full contractions)
+  /// to a UTF-8 text file, 2 lines per entry (the key and the deparsed value)
+  /// @param path the file path
+  /// @throw std::runtime_error if could not write to @p path
+  void save(const std::filesystem::path &path) const;
+
+  /// reads the entries written by save(); existing entries are kept
+  /// @param path the file path
+  /// @throw std::runtime_error if could not read from @p path
+  /// @throw ParseError if the values could not be parsed
+  void load(const std::filesystem::path &path);
+
+ private:
+  mutable std::shared_mutex mtx_;  // guards entries_
+  std::unordered_map<std::wstring, ExprPtr> entries_;
+  mutable std::atomic<std::size_t> nhits_ = 0;
+  mutable std::atomic<std::size_t> nmisses_ = 0;
+};
+
+}  // namespace sequant
+
+#endif  // SEQUANT_CORE_WICK_CACHE_HPP
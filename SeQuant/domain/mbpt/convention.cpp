@@ -219,14 +219,16 @@ make_fermi_and_bose_spaces() {
   add_fermi_spin(*isr);
   isr->add(L"β", 0b100);  // bose
 
-  auto fermi_isr = std::make_shared<IndexSpaceRegistry>(isr->spaces());
+  auto fermi_isr = std::make_shared<IndexSpaceRegistry>(
+      IndexSpaceRegistry::sharing_spaces(*isr));
   fermi_isr->vacuum_occupied_space(L"i");
   fermi_isr->reference_occupied_space(L"i");
   fermi_isr->hole_space(L"i");
   fermi_isr->particle_space(L"a");
   fermi_isr->complete_space(L"p");
 
-  auto bose_isr = std::make_shared<IndexSpaceRegistry>(isr->spaces());
+  auto bose_isr = std::make_shared<IndexSpaceRegistry>(
+      IndexSpaceRegistry::sharing_spaces(*isr));
   bose_isr->vacuum_occupied_space(IndexSpace::null);
   bose_isr->reference_occupied_space(IndexSpace::null);
   bose_isr->hole_space(IndexSpace::null);
@@ -59,13 +59,18 @@ ExprPtr CC::sim_tr(ExprPtr expr, size_t commutator_rank) {
       return transform_op_op_pdt(expr);
     }
   } else if (expr.is<Sum>()) {
+    // N.B. all values being reduced are Sums made (hence owned) by this
+    // reduction, so they are accumulated in place
     auto result = sequant::transform_reduce(
         *expr, ex<Sum>(),
-        [](const ExprPtr& running_total, const ExprPtr& summand) {
-          return running_total + summand;
+        [](ExprPtr running_total, ExprPtr summand) {
+          running_total.as<Sum>().adopt(std::move(summand));
+          return running_total;
         },
         [=](const auto& op_product) {
-          return transform_op_op_pdt(op_product);
+          auto summand = ex<Sum>();
+          summand.as<Sum>().append(transform_op_op_pdt(op_product));
+          return summand;
         });
     return result;
   } else if (expr.is<Constant>() || expr.is<Variable>())
@@ -108,13 +108,19 @@ ExprPtr vac_av(
     } else
       return vac_av_product(expr);
   } else if (expr.is<Sum>()) {
+    // N.B. all values being reduced are Sums made (hence owned) by this
+    // reduction, so they are accumulated in place
     result = sequant::transform_reduce(
         *expr, ex<Sum>(),
-        [](const ExprPtr& running_total, const ExprPtr& summand) {
-          return running_total + summand;
+        [](ExprPtr running_total, ExprPtr summand) {
+          running_total.as<Sum>().adopt(std::move(summand));
+          return running_total;
         },
         [&op_connections](const auto& op_product) {
-          return vac_av(op_product, op_connections, /* skip_clone = */ true);
+          auto summand = ex<Sum>();
+          summand.as<Sum>().append(
+              vac_av(op_product, op_connections, /* skip_clone = */ true));
+          return summand;
         });
     simplify(result);  // combine possible equivalent summands
     return result;
@@ -3,6 +3,9 @@
 #include <SeQuant/core/expr.hpp>
 #include <SeQuant/core/expr_algorithm.hpp>
 #include <SeQuant/core/parse.hpp>
+#include <SeQuant/core/utility/memory_resource.hpp>
+
+#include <optional>
 
 using namespace sequant;
 
@@ -26,11 +29,14 @@ static ExprPtr get_expression(std::size_t i) {
   throw "Invalid index";
 }
 
-template <bool rapid_only>
+template <bool rapid_only, bool use_pool = false>
 static void simplify(benchmark::State &state) {
   ExprPtr input = get_expression(state.range(0));
 
   for (auto _ : state) {
+    std::optional<ScopedExprMemoryResource> pool;
+    if constexpr (use_pool) pool.emplace();
+
     ExprPtr expression = input->clone();
     if constexpr (rapid_only) {
       rapid_simplify(expression);
@@ -46,3 +52,7 @@ static void simplify(benchmark::State &state) {
 BENCHMARK(simplify<false>)->Name("simplify")->DenseRange(1, nInputs);
 
 BENCHMARK(simplify<true>)->Name("rapid_simplify")->DenseRange(1, nInputs);
+
+BENCHMARK(simplify<false, true>)
+    ->Name("simplify_pooled")
+    ->DenseRange(1, nInputs);
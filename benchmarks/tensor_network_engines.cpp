@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <SeQuant/core/attr.hpp>
+#include <SeQuant/core/context.hpp>
+#include <SeQuant/core/expr.hpp>
+#include <SeQuant/core/expr_algorithm.hpp>
+#include <SeQuant/core/parse.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace sequant;
+
+// Count heap allocations to report them alongside the timings
+// N.B. this replaces the global allocation functions for the entire
+// executable, hence this benchmark is built separately from the others
+// (see CMakeLists.txt); the overhead is an atomic increment per allocation
+static std::atomic<std::size_t> num_allocations = 0;
+
+void *operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// products appearing in the CCSD equations
+static const std::vector<std::wstring> &get_corpus() {
+  static const std::vector<std::wstring> corpus = {
+      L"f{a1;i1} t{a2;i2}",
+      L"g{i3,a1;i1,a3}:A t{a3;i3}:A",
+      L"g{i3,i4;a3,a4}:A t{a3;i3}:A t{a4,a1;i4,i1}:A",
+      L"g{i3,i4;a3,a4}:A t{a1,a3;i1,i3}:A t{a2,a4;i2,i4}:A",
+      L"g{i3,i4;a3,a4}:A t{a3,a4;i1,i2}:A t{a1,a2;i3,i4}:A",
+      L"g{i3,i4;a3,a4}:A t{a1,a2;i1,i3}:A t{a3,a4;i2,i4}:A",
+      L"g{i3,i4;a3,a4}:A t{a3;i1}:A t{a4;i2}:A t{a1,a2;i3,i4}:A",
+      L"g{i3,i4;a3,a4}:A t{a1;i3}:A t{a3;i1}:A t{a2,a4;i2,i4}:A",
+      L"g{i3,i4;a3,a4}:A t{a1;i3}:A t{a2;i4}:A t{a3;i1}:A t{a4;i2}:A",
+      L"A{i1,i2;a1,a2}:A g{a1,a2;a3,a4}:A t{a3;i1}:A t{a4;i2}:A",
+      L"A{i1,i2;a1,a2}:A g{i3,a2;a3,a4}:A t{a3;i1}:A t{a4,a1;i2,i3}:A",
+      L"A{i1,i2;a1,a2}:A f{i3;a3} t{a3;i1}:A t{a1,a2;i3,i2}:A",
+  };
+  return corpus;
+}
+
+/// @return the canonical form of @p expr computed using @p engine
+static ExprPtr canonicalize_with(const ExprPtr &expr,
+                                 TensorNetworkEngine engine) {
+  auto resetter = set_scoped_default_context(
+      Context(get_default_context()).set(engine));
+  return canonicalize(expr->clone());
+}
+
+/// the engines need not produce the same canonical form, but each must map
+/// the canonical form produced by the other onto its own
+/// @return true if the canonical forms produced by the engines are equivalent
+static bool engines_agree(const ExprPtr &expr) {
+  const auto canon_v1 = canonicalize_with(expr, TensorNetworkEngine::V1);
+  const auto canon_v2 = canonicalize_with(expr, TensorNetworkEngine::V2);
+  return *canonicalize_with(canon_v2, TensorNetworkEngine::V1) == *canon_v1 &&
+         *canonicalize_with(canon_v1, TensorNetworkEngine::V2) == *canon_v2;
+}
+
+static void tensor_network_engine(benchmark::State &state) {
+  const auto engine = static_cast<TensorNetworkEngine>(state.range(0));
+  const ExprPtr input = parse_expr(get_corpus().at(state.range(1)));
+
+  if (!engines_agree(input)) {
+    state.SkipWithError("TensorNetwork engines produce different results");
+    return;
+  }
+
+  auto resetter = set_scoped_default_context(
+      Context(get_default_context()).set(engine));
+
+  const auto num_allocations_start = num_allocations.load();
+  for (auto _ : state) {
+    ExprPtr canonicalized = canonicalize(input->clone());
+
+    // Prevent canonicalization from being optimized away by the compiler
+    benchmark::DoNotOptimize(canonicalized);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(num_allocations.load() - num_allocations_start),
+      benchmark::Counter::kAvgIterations);
+  state.SetLabel(engine == TensorNetworkEngine::V1 ? "TensorNetwork"
+                                                   : "TensorNetworkV2");
+}
+
+BENCHMARK(tensor_network_engine)
+    ->ArgNames({"engine", "input"})
+    ->ArgsProduct(
+        {{static_cast<long>(TensorNetworkEngine::V1),
+          static_cast<long>(TensorNetworkEngine::V2)},
+         benchmark::CreateDenseRange(
+             0, static_cast<long>(get_corpus().size()) - 1, 1)});
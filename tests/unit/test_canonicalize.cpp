@@ -9,6 +9,7 @@
 #include <SeQuant/core/index.hpp>
 #include <SeQuant/core/latex.hpp>
 #include <SeQuant/core/rational.hpp>
+#include <SeQuant/core/runtime.hpp>
 #include <SeQuant/core/tensor.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
 #include <SeQuant/core/tensor_network.hpp>
@@ -20,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include <range/v3/all.hpp>
 
@@ -397,6 +399,133 @@ TEST_CASE("canonicalization", "[algorithms]") {
           input,
           EquivalentTo("t{a2;i4} t{a1,a3;i3,i2} B{i3;i1;p5} B{i4;a3;p5}"));
     }
+
+    // Case 7: summands are canonicalized concurrently
+    {
+      const auto nthreads = num_threads();
+      const std::wstring input =
+          L"g{i3,i4;a3,a4}:A t{a1,a3;i1,i3}:A t{a2,a4;i2,i4}:A"
+          L" + g{i5,i6;a5,a6}:A t{a1,a5;i1,i5}:A t{a2,a6;i2,i6}:A"
+          L" + g{i3,i4;a3,a4}:A t{a3;i1}:A t{a4;i2}:A t{a1,a2;i3,i4}:A"
+          L" - g{i4,i3;a3,a4}:A t{a3;i1}:A t{a4;i2}:A t{a1,a2;i3,i4}:A"
+          L" + f{i3;a3} t{a3;i1} t{a1,a2;i3,i2}:A"
+          L" + f{i5;a5} t{a5;i1} t{a1,a2;i5,i2}:A";
+
+      set_num_threads(1);
+      auto serial = parse_expr(input);
+      canonicalize(serial);
+
+      set_num_threads(4);
+      auto concurrent = parse_expr(input);
+      canonicalize(concurrent);
+      set_num_threads(nthreads);
+
+      REQUIRE(serial->size() == 3);
+      REQUIRE(to_latex(serial) == to_latex(concurrent));
+    }
+  }
+
+  SECTION("TensorNetworkEngine") {
+    REQUIRE(get_default_context().tensor_network_engine() ==
+            Context::Defaults::tensor_network_engine);
+    for (auto engine : {TensorNetworkEngine::V1, TensorNetworkEngine::V2}) {
+      auto engine_resetter =
+          set_scoped_default_context(Context(get_default_context()).set(engine));
+      REQUIRE(get_default_context().tensor_network_engine() == engine);
+
+      // same product, up to the dummy labels and the order of factors
+      auto input1 = parse_expr(
+          L"g{i3,i4;a3,a4}:A t{a1,a3;i1,i3}:A t{a2,a4;i2,i4}:A");
+      auto input2 = parse_expr(
+          L"t{a2,a6;i2,i5}:A g{i7,i5;a5,a6}:A t{a1,a5;i1,i7}:A");
+      canonicalize(input1);
+      canonicalize(input2);
+      REQUIRE(to_latex(input1) == to_latex(input2));
+    }
+  }
+
+  SECTION("TensorCanonicalizer registry") {
+    auto default_canonicalizer = TensorCanonicalizer::instance_ptr();
+    REQUIRE(default_canonicalizer);
+
+    // label-specific canonicalizers take precedence over the default one
+    auto null_canonicalizer = std::make_shared<NullTensorCanonicalizer>();
+    REQUIRE(TensorCanonicalizer::try_register_instance(null_canonicalizer,
+                                                       L"Z"));
+    REQUIRE_FALSE(TensorCanonicalizer::try_register_instance(
+        default_canonicalizer, L"Z"));
+    REQUIRE(TensorCanonicalizer::instance_ptr(L"Z") == null_canonicalizer);
+    REQUIRE(TensorCanonicalizer::instance_ptr(L"g") == default_canonicalizer);
+    REQUIRE(!TensorCanonicalizer::nondefault_instance_ptr(L"g"));
+
+    // concurrent lookups
+    const auto nthreads = num_threads();
+    set_num_threads(4);
+    std::vector<ExprPtr> ops;
+    for (std::size_t i = 0; i != 16; ++i)
+      ops.push_back(ex<Tensor>(i % 2 == 0 ? L"Z" : L"g", bra{L"p_2", L"p_1"},
+                               ket{L"p_3", L"p_4"}, Symmetry::antisymm));
+    sequant::for_each(ops, [](ExprPtr& op) { canonicalize(op); });
+    set_num_threads(nthreads);
+    for (std::size_t i = 0; i != ops.size(); ++i) {
+      // Z is not canonicalized, g is
+      REQUIRE(ops[i]->as<Tensor>().bra().front().label() ==
+              (i % 2 == 0 ? L"p_2" : L"p_1"));
+    }
+
+    TensorCanonicalizer::deregister_instance(L"Z");
+    REQUIRE(TensorCanonicalizer::instance_ptr(L"Z") == default_canonicalizer);
+  }
+
+  SECTION("Product canonical state") {
+    auto input =
+        parse_expr(L"g{i3,i4;a3,a4}:A t{a2,a4;i2,i4}:A t{a1,a3;i1,i3}:A");
+    const auto& product = input->as<Product>();
+    REQUIRE(!product.is_canonical());
+
+    canonicalize(input);
+    REQUIRE(product.is_canonical());
+    REQUIRE(!product.is_canonical(/* rapid = */ true));
+    const auto canonical_latex = to_latex(input);
+
+    // canonicalizing a canonical product is a no-op
+    canonicalize(input);
+    REQUIRE(product.is_canonical());
+    REQUIRE(to_latex(input) == canonical_latex);
+
+    // copies are canonical also
+    REQUIRE(Product(product).is_canonical());
+
+    // in-place mutation of a factor invalidates the state
+    product.factor(1)->adjoint();
+    REQUIRE(!product.is_canonical());
+    product.factor(1)->adjoint();
+    canonicalize(input);
+    REQUIRE(product.is_canonical());
+    REQUIRE(to_latex(input) == canonical_latex);
+
+    // so does the mutation of the product
+    input->as<Product>().append(1, ex<Variable>(L"λ"));
+    REQUIRE(!product.is_canonical());
+    canonicalize(input);
+    REQUIRE(product.is_canonical());
+
+    // so does the change of the canonicalization settings
+    TensorCanonicalizer::set_cardinal_tensor_labels(
+        TensorCanonicalizer::cardinal_tensor_labels());
+    REQUIRE(!product.is_canonical());
+
+    // summands stay canonical across simplify passes
+    auto sum = parse_expr(
+        L"g{i3,i4;a3,a4}:A t{a2,a4;i2,i4}:A t{a1,a3;i1,i3}:A + "
+        L"g{i3,i4;a3,a4}:A t{a3,a4;i1,i2}:A t{a1,a2;i3,i4}:A");
+    simplify(sum);
+    const auto simplified_latex = to_latex(sum);
+    // N.B. the last pass of Sum canonicalization is rapid
+    for (auto&& summand : *sum)
+      REQUIRE(summand->as<Product>().is_canonical(/* rapid = */ true));
+    simplify(sum);
+    REQUIRE(to_latex(sum) == simplified_latex);
   }
 
   SECTION("TN isomorphism") {
@@ -12,15 +12,19 @@
 #include <SeQuant/core/hash.hpp>
 #include <SeQuant/core/latex.hpp>
 #include <SeQuant/core/meta.hpp>
+#include <SeQuant/core/runtime.hpp>
+#include <SeQuant/core/tensor.hpp>
 #include <SeQuant/core/wolfram.hpp>
 #include <SeQuant/domain/mbpt/convention.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -375,6 +379,186 @@ TEST_CASE("expr", "[elements]") {
     }
   }  // SECTION("clone")
 
+  SECTION("memory resource") {
+    struct CountingResource : std::pmr::memory_resource {
+      std::atomic<std::size_t> nallocations = 0;
+      void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++nallocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+      }
+      void do_deallocate(void *ptr, std::size_t bytes,
+                         std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+      }
+      bool do_is_equal(
+          const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+      }
+    };
+
+    REQUIRE(!expr_memory_resource());
+    auto resource = std::make_shared<CountingResource>();
+    std::weak_ptr<std::pmr::memory_resource> resource_observer = resource;
+    ExprPtr survivor;
+    {
+      ScopedExprMemoryResource scope(resource);
+      REQUIRE(expr_memory_resource() == resource);
+      survivor = ex<Constant>(2) * ex<Variable>(L"x");
+      REQUIRE(resource->nallocations.load() >= 2);
+      {  // nested scope reinstates the global heap
+        ScopedExprMemoryResource nested(nullptr);
+        REQUIRE(!expr_memory_resource());
+        const std::size_t nallocations = resource->nallocations;
+        REQUIRE(ex<Constant>(1)->is<Constant>());
+        REQUIRE(resource->nallocations.load() == nallocations);
+      }
+      REQUIRE(expr_memory_resource() == resource);
+
+      // the tasks submitted to the thread pool use it too
+      {
+        const auto nthreads = num_threads();
+        set_num_threads(4);
+        const std::size_t nallocations = resource->nallocations;
+        std::vector<ExprPtr> constants(64);
+        sequant::for_each(constants, [](ExprPtr &constant) {
+          constant = ex<Constant>(1);
+        });
+        set_num_threads(nthreads);
+        REQUIRE(resource->nallocations.load() ==
+                nallocations + constants.size());
+      }
+    }
+    REQUIRE(!expr_memory_resource());
+    const std::size_t nallocations = resource->nallocations;
+    REQUIRE(ex<Constant>(1)->is<Constant>());
+    REQUIRE(resource->nallocations.load() == nallocations);
+
+    // the objects keep the resource alive
+    resource.reset();
+    REQUIRE(!resource_observer.expired());
+    REQUIRE(survivor->clone() == survivor);
+    survivor.reset();
+    REQUIRE(resource_observer.expired());
+  }
+
+  SECTION("sum") {
+    const auto x = ex<Variable>(L"x");
+    const auto y = ex<Variable>(L"y");
+    const auto z = ex<Variable>(L"z");
+
+    // append clones the summands, adopt does not
+    Sum sum;
+    sum.append(x);
+    CHECK(sum.summand(0).get() != x.get());
+    auto w = ex<Variable>(L"w");
+    const auto* w_ptr = w.get();
+    sum.adopt(std::move(w));
+    CHECK(sum.summand(1).get() == w_ptr);
+    CHECK(sum.size() == 2);
+
+    // prepending a Sum inserts its summands in the reverse order and adds up
+    // the constants
+    sum.prepend(ex<Sum>(ExprPtrList{ex<Constant>(1), y, ex<Constant>(2), z}));
+    REQUIRE(sum.size() == 5);
+    CHECK(sum.summand(0) == z);
+    CHECK(sum.summand(1) == y);
+    CHECK(sum.summand(2) == ex<Constant>(3));
+    CHECK(sum.summand(3) == x);
+    sum.append(ex<Constant>(-3));
+    CHECK(sum.summand(2) == ex<Constant>(0));
+    sum.prepend(ex<Constant>(1));
+    CHECK(sum.size() == 5);
+    CHECK(sum.summand(2) == ex<Constant>(1));
+
+    // appending a uniquely-owned shallow copy still clones its factors, hence
+    // canonicalizing the sum leaves the original intact
+    {
+      const auto product = ex<Product>(ExprPtrList{
+          ex<Tensor>(L"g", bra{L"p_7", L"p_9"}, ket{L"p_5", L"p_8"},
+                     Symmetry::antisymm),
+          ex<Tensor>(L"t", bra{L"p_8", L"p_5"}, ket{L"p_9", L"p_7"},
+                     Symmetry::antisymm)});
+      const auto product_latex = to_latex(product);
+      auto sum2 = ex<Sum>();
+      sum2.as<Sum>().append(std::make_shared<Product>(product->as<Product>()));
+      CHECK(sum2.as<Sum>().summand(0).as<Product>().factor(0).get() !=
+            product.as<Product>().factor(0).get());
+      canonicalize(sum2);
+      CHECK(to_latex(product) == product_latex);
+    }
+
+    // append_range clones the summands
+    container::svector<ExprPtr> summands{ex<Variable>(L"u"),
+                                         ex<Variable>(L"v")};
+    Sum sum3;
+    sum3.append_range(summands);
+    CHECK(sum3.size() == 2);
+    CHECK(sum3.summand(0) == summands[0]);
+    CHECK(sum3.summand(0).get() != summands[0].get());
+
+    // adopting a Sum adopts its summands
+    {
+      auto u = ex<Variable>(L"u");
+      const auto* u_ptr = u.get();
+      auto subsum = ex<Sum>();
+      subsum.as<Sum>().adopt(ex<Constant>(2)).adopt(std::move(u));
+      Sum sum4;
+      sum4.adopt(std::move(subsum));
+      REQUIRE(sum4.size() == 2);
+      CHECK(sum4.summand(1).get() == u_ptr);
+    }
+
+    // the constant summands of copies are not shared
+    {
+      Sum sum5;
+      sum5.append(ex<Constant>(1));
+      const Sum sum5_copy(sum5);
+      sum5.append(ex<Constant>(1));
+      CHECK(sum5.summand(0) == ex<Constant>(2));
+      CHECK(sum5_copy.summand(0) == ex<Constant>(1));
+    }
+
+    // operator+ does not modify its operands, even if they are rvalues
+    {
+      ExprPtr total = ex<Sum>(ExprPtrList{x});
+      const auto total_copy = total;
+      const auto total2 = std::move(total) + y;
+      CHECK(total_copy->size() == 1);
+      CHECK(total2->size() == 2);
+    }
+
+    // interleaved prepends and appends keep the order of the summands
+    {
+      Sum sum6;
+      container::svector<ExprPtr> expected;
+      for (int i = 0; i != 20; ++i) {
+        auto summand = ex<Variable>(L"v" + std::to_wstring(i));
+        if (i % 3 == 0) {
+          sum6.append(summand);
+          expected.push_back(summand);
+        } else {
+          sum6.prepend(summand);
+          expected.insert(expected.begin(), summand);
+        }
+        if (i == 10) {
+          sum6.prepend(ex<Constant>(2));
+          expected.insert(expected.begin(), ex<Constant>(2));
+        }
+      }
+      sum6.append(ex<Constant>(1));
+      *ranges::find_if(expected, [](const auto& e) {
+        return e->template is<Constant>();
+      }) = ex<Constant>(3);
+      REQUIRE(sum6.size() == expected.size());
+      CHECK(ranges::equal(sum6.summands(), expected,
+                          [](const auto& e1, const auto& e2) {
+                            return *e1 == *e2;
+                          }));
+      CHECK(*sum6.clone() == sum6);
+      CHECK(*sum6.clone() == Sum(expected.begin(), expected.end()));
+    }
+  }
+
   SECTION("latex") {
     {  // Variable
       const auto e = std::make_shared<Variable>(L"q");
@@ -133,6 +133,45 @@ TEST_CASE("index", "[elements][index]") {
     // check copy ctor
     Index i4(i2);
     REQUIRE(i2 == i4);
+
+    // labels are interned, equal labels share storage
+    REQUIRE(i1.label().data() == i3.label().data());
+    REQUIRE(i2.label().data() == i4.label().data());
+    REQUIRE(Index(std::string("i_1")).label().data() == i1.label().data());
+
+    // generated labels are not interned, but still compare by value
+    IndexFactory factory(nullptr, 1);
+    const auto f1 = factory.make(i1.space());
+    REQUIRE(f1.label() == i1.label());
+    REQUIRE(f1.label().data() != i1.label().data());
+    REQUIRE(f1 == i1);
+    REQUIRE(f1.label_hash() == i1.label_hash());
+    REQUIRE(factory.make(i1.space()) == i2);
+    const auto tmp = Index::make_tmp_index(i1.space());
+    REQUIRE(tmp == Index(tmp));
+    REQUIRE(tmp != i1);
+
+    // generated labels are ordered like the user-provided ones
+    const auto f3 = factory.make(i1.space());
+    REQUIRE(f3.label() == L"i_3");
+    REQUIRE(i2 < f3);
+    REQUIRE(!(f3 < i2));
+    REQUIRE(f1 < f3);
+    REQUIRE(f3 < Index(L"i_11"));
+
+    // labels of the form base_ordinal are represented by the interned base
+    // and the integer ordinal, hence compare by value in O(1)
+    using detail::InternedWString;
+    const InternedWString i_3(L"i_3");
+    REQUIRE(i_3.base_id() != nullptr);
+    REQUIRE(i_3.base_id() == InternedWString(L"i_11").base_id());
+    REQUIRE(i_3.ordinal() == 3);
+    REQUIRE(InternedWString::transient(L"i_3") == i_3);
+    REQUIRE(InternedWString::transient(InternedWString(L"i"), 3) == i_3);
+    REQUIRE(InternedWString::transient(L"i_03") != i_3);
+    REQUIRE(InternedWString::transient(L"i_03").base_id() == nullptr);
+    REQUIRE(InternedWString::transient(L"i_03") ==
+            InternedWString::transient(L"i_03"));
   }
 
   SECTION("ordering") {
@@ -204,6 +243,10 @@ TEST_CASE("index", "[elements][index]") {
     REQUIRE(hash_value(i1) != hash_value(i2));
     REQUIRE(i1.label() == i3.label());
     REQUIRE(hash_value(i1) != hash_value(i3));
+
+    // hash of the interned label is the hash of the label itself
+    REQUIRE(i1.label_hash() == hash::value(i1.label()));
+    REQUIRE(Index{}.label_hash() == hash::value(Index{}.label()));
   }
 
   SECTION("transform") {
@@ -8,9 +8,16 @@
 
 #include <SeQuant/core/attr.hpp>
 #include <SeQuant/core/context.hpp>
+#include <SeQuant/core/runtime.hpp>
 #include <SeQuant/domain/mbpt/convention.hpp>
 
+#include <atomic>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE("context", "[runtime]") {
   using namespace sequant;
@@ -71,4 +78,105 @@ TEST_CASE("context", "[runtime]") {
   }
   // leaving scope resets the context back
   CHECK(get_default_context() == initial_ctx);
+
+  // a reference to the default context stays valid until the default context
+  // is read again after its modification
+  {
+    const Context& ctx = get_default_context();
+    auto resetter = set_scoped_default_context(
+        Context(mbpt::make_sr_spaces(), Vacuum::SingleProduct));
+    CHECK(ctx == initial_ctx);
+    CHECK(get_default_context().vacuum() == Vacuum::SingleProduct);
+  }
+
+  // replaced contexts are released once no longer read
+  {
+    auto isr = mbpt::make_sr_spaces();
+    std::weak_ptr<IndexSpaceRegistry> isr_observer = isr;
+    for (int i = 0; i != 3; ++i) {
+      auto resetter = set_scoped_default_context(
+          Context(isr, Vacuum::SingleProduct));
+      CHECK(get_default_context().index_space_registry() == isr);
+    }
+    CHECK(get_default_context() == initial_ctx);
+    isr.reset();
+    CHECK(isr_observer.expired());
+  }
+
+  // modifications are seen by all threads
+  {
+    const auto nthreads = num_threads();
+    set_num_threads(4);
+    auto count_vacuum = [](Vacuum vacuum) {
+      std::vector<int> matches(16, 0);
+      sequant::for_each(matches, [vacuum](int& match) {
+        match = get_default_context().vacuum() == vacuum;
+      });
+      return std::accumulate(matches.begin(), matches.end(), 0);
+    };
+    {
+      auto resetter = set_scoped_default_context(
+          Context(mbpt::make_sr_spaces(), Vacuum::SingleProduct));
+      CHECK(count_vacuum(Vacuum::SingleProduct) == 16);
+    }
+    CHECK(count_vacuum(initial_ctx.vacuum()) == 16);
+    set_num_threads(nthreads);
+  }
+}
+
+TEST_CASE("thread_pool", "[runtime]") {
+  using namespace sequant;
+
+  const auto initial_nthreads = num_threads();
+
+  for (int nthreads : {1, 2, 4}) {
+    set_num_threads(nthreads);
+
+    std::vector<int> v(200);
+    std::iota(v.begin(), v.end(), 0);
+
+    // nested for_each
+    std::atomic<long> sum = 0;
+    sequant::for_each(v, [&sum](int i) {
+      std::vector<int> w(10, i);
+      sequant::for_each(w, [&sum](int j) { sum += j; });
+    });
+    CHECK(sum == 10L * 199 * 200 / 2);
+
+    // transform_reduce includes init exactly once, works with non-random
+    // access ranges
+    std::list<int> l(v.begin(), v.end());
+    CHECK(sequant::transform_reduce(
+              l, 7L, [](long a, long b) { return a + b; },
+              [](int i) { return 2L * i; }) == 7 + 199L * 200);
+
+    std::atomic<int> nlambdas = 0;
+    parallel_do([&nlambdas](int) { ++nlambdas; });
+    CHECK(nlambdas == nthreads);
+
+    // exceptions propagate to the caller
+    CHECK_THROWS_AS(sequant::for_each(v,
+                                      [](int i) {
+                                        if (i == 100)
+                                          throw std::runtime_error("boom");
+                                      }),
+                    std::runtime_error);
+  }
+
+  // changing the number of threads while parallel work is in flight: the
+  // old pool completes the work and is released afterwards
+  {
+    set_num_threads(4);
+    std::vector<int> v(64, 1);
+    std::atomic<int> sum = 0;
+    sequant::for_each(v, [&sum](int i) {
+      if (sum.fetch_add(i) == 8) set_num_threads(2);
+      std::vector<int> w(4, i);
+      sequant::for_each(w, [&sum](int j) { sum += j; });
+    });
+    CHECK(sum == 5 * 64);
+    CHECK(detail::ThreadPool::instance()->nworkers() == 1);
+  }
+
+  set_num_threads(initial_nthreads);
 }
@@ -26,6 +26,40 @@ TEST_CASE("index_space", "[elements]") {
     REQUIRE_THROWS(sr_isr->add(
         jactive_occupied));  // cannot add a space with duplicate attr
 
+    // lookups by attribute see the updates
+    REQUIRE(sr_isr->retrieve(active_occupied.attr()) == active_occupied);
+    REQUIRE(sr_isr->retrieve(active_occupied.type(), active_occupied.qns()) ==
+            active_occupied);
+    REQUIRE_NOTHROW(sr_isr->remove(L"i"));
+    REQUIRE(!sr_isr->contains(active_occupied.attr()));
+    REQUIRE_NOTHROW(sr_isr->add(active_occupied));
+    REQUIRE(sr_isr->contains(active_occupied.attr()));
+
+    // copies share the spaces, hence lookups by attribute via a copy see the
+    // updates made via the original
+    {
+      IndexSpaceRegistry isr_copy(*sr_isr);
+      REQUIRE(isr_copy.retrieve(active_occupied.attr()) == active_occupied);
+      IndexSpace new_occupied(L"i", 0b10000000000);
+      REQUIRE_NOTHROW(sr_isr->replace(new_occupied));
+      REQUIRE(isr_copy.spaces()->size() == sr_isr->spaces()->size());
+      REQUIRE(!isr_copy.contains(active_occupied.attr()));
+      REQUIRE(isr_copy.retrieve(new_occupied.attr()) == new_occupied);
+      REQUIRE_NOTHROW(sr_isr->remove(L"i").add(active_occupied));
+      REQUIRE(!isr_copy.contains(new_occupied.attr()));
+      REQUIRE(isr_copy.retrieve(active_occupied.attr()) == active_occupied);
+
+      // ditto for the registries that share only the spaces
+      auto isr_sharing = IndexSpaceRegistry::sharing_spaces(*sr_isr);
+      REQUIRE(isr_sharing.spaces() == sr_isr->spaces());
+      REQUIRE_NOTHROW(sr_isr->replace(new_occupied));
+      REQUIRE(!isr_sharing.contains(active_occupied.attr()));
+      REQUIRE(isr_sharing.retrieve(new_occupied.attr()) == new_occupied);
+      REQUIRE_NOTHROW(isr_sharing.replace(active_occupied));
+      REQUIRE(!sr_isr->contains(new_occupied.attr()));
+      REQUIRE(sr_isr->retrieve(active_occupied.attr()) == active_occupied);
+    }
+
     // can use bytestrings too
     REQUIRE_NOTHROW(sr_isr->retrieve("a"));  // N.B. string
     REQUIRE_NOTHROW(sr_isr->remove('a'));    // N.B. char
@@ -75,6 +109,13 @@ TEST_CASE("index_space", "[elements]") {
     auto sr_isr = sequant::mbpt::make_sr_spaces();
     REQUIRE(sr_isr->retrieve(L"i") == sr_isr->retrieve(L"i"));
     REQUIRE(sr_isr->retrieve(L"i") != sr_isr->retrieve(L"a"));
+
+    // base keys are interned, equal keys share storage
+    IndexSpace i(L"i", 0b0010);
+    REQUIRE(i.base_key().data() == IndexSpace("i", 0b0010).base_key().data());
+    REQUIRE(i == IndexSpace("i", 0b0010));
+    REQUIRE(i != IndexSpace(L"j", 0b0010));
+    REQUIRE(i != IndexSpace(L"i", 0b0100));
   }
 
   SECTION("ordering") {
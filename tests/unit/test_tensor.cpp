@@ -16,6 +16,7 @@
 #include <SeQuant/core/op.hpp>
 #include <SeQuant/core/tag.hpp>
 #include <SeQuant/core/tensor.hpp>
+#include <SeQuant/core/tensor_canonicalizer.hpp>
 #include <SeQuant/domain/mbpt/context.hpp>
 #include <SeQuant/domain/mbpt/convention.hpp>
 
@@ -195,4 +196,35 @@ TEST_CASE("tensor", "[elements]") {
             L"{{F^{{i_2}}_{{i_1}}}{\\tilde{a}^{{i_1}}_{{i_2}}}}");
 
   }  // SECTION("adjoint")
+
+  SECTION("canonicalize") {
+    DefaultTensorCanonicalizer canonicalizer;
+
+    auto t1 = Tensor(L"g", bra{L"i_2", L"i_1"}, ket{L"a_1", L"a_2"},
+                     Symmetry::antisymm);
+    const auto t1_canonical = Tensor(L"g", bra{L"i_1", L"i_2"},
+                                     ket{L"a_1", L"a_2"}, Symmetry::antisymm);
+    ExprPtr byproduct;
+    REQUIRE_NOTHROW(byproduct = canonicalizer.apply(t1));
+    REQUIRE(byproduct);
+    REQUIRE(byproduct->as<Constant>().value() == -1);
+    REQUIRE(t1 == t1_canonical);
+    REQUIRE(hash_value(t1) == hash_value(t1_canonical));
+
+    // Tensor is canonicalized same as via the AbstractTensor interface
+    auto t2 = Tensor(L"t", bra{L"a_2", L"a_1", L"a_3"}, ket{L"i_1", L"i_3"},
+                     Symmetry::nonsymm);
+    auto t3 = t2;
+    const auto byproduct2 = canonicalizer.apply(
+        t2, TensorCanonicalizer::index_comparer(),
+        TensorCanonicalizer::index_pair_comparer());
+    const auto byproduct3 = canonicalizer.apply(
+        static_cast<AbstractTensor&>(t3), TensorCanonicalizer::index_comparer(),
+        TensorCanonicalizer::index_pair_comparer());
+    REQUIRE(!byproduct2);
+    REQUIRE(!byproduct3);
+    REQUIRE(t2 == t3);
+    REQUIRE(to_latex(t2) == L"{t^{{i_3}{i_1}}_{{a_1}{a_2}{a_3}}}");
+
+  }  // SECTION("canonicalize")
 }
@@ -20,6 +20,7 @@
 #include <SeQuant/core/tensor.hpp>
 #include <SeQuant/core/tensor_canonicalizer.hpp>
 #include <SeQuant/core/tensor_network.hpp>
+#include <SeQuant/core/tensor_network/canonical_form_cache.hpp>
 #include <SeQuant/core/tensor_network_v2.hpp>
 #include <SeQuant/core/timer.hpp>
 #include <SeQuant/core/utility/string.hpp>
@@ -552,6 +553,16 @@ class TensorNetworkV2Accessor {
     return std::make_pair(std::move(graph.bliss_graph), graph.vertex_labels);
   }
 };
+
+/// installs a CanonicalFormCache for its lifetime, then restores the
+/// previously installed one
+struct ScopedCanonicalFormCache {
+  std::shared_ptr<CanonicalFormCache> previous = CanonicalFormCache::instance();
+  explicit ScopedCanonicalFormCache(std::shared_ptr<CanonicalFormCache> cache) {
+    CanonicalFormCache::set_instance(std::move(cache));
+  }
+  ~ScopedCanonicalFormCache() { CanonicalFormCache::set_instance(previous); }
+};
 }  // namespace sequant
 
 TEST_CASE("tensor_network_v2", "[elements]") {
@@ -1054,6 +1065,128 @@ TEST_CASE("tensor_network_v2", "[elements]") {
       }
     }  // SECTION("idempotency")
 
+    SECTION("canonical form cache") {
+      auto cache = std::make_shared<CanonicalFormCache>();
+      ScopedCanonicalFormCache scoped_cache(cache);
+
+      // same topology, different dummy labels
+      const std::vector<std::wstring> inputs = {
+          L"g{i3,i4;a3,a4}:A t{a1,a3;i1,i3}:A t{a2,a4;i2,i4}:A",
+          L"g{i5,i7;a5,a8}:A t{a1,a5;i1,i5}:A t{a2,a8;i2,i7}:A",
+          L"g{i6,i9;a6,a7}:A t{a1,a6;i1,i6}:A t{a2,a7;i2,i9}:A",
+      };
+
+      auto canonicalize = [](const std::wstring& input) {
+        auto factors = parse_expr(input).as<Product>().factors();
+        TensorNetworkV2 tn(factors);
+        tn.canonicalize(TensorCanonicalizer::cardinal_tensor_labels(), false);
+        return to_latex(to_product(tn.tensors()));
+      };
+
+      std::vector<std::wstring> cached;
+      for (const auto& input : inputs) cached.push_back(canonicalize(input));
+      REQUIRE(cache->size() == 1);
+      REQUIRE(cache->nhits() == inputs.size() - 1);
+      REQUIRE(cache->nmisses() == 1);
+
+      // must match the results computed without the cache
+      CanonicalFormCache::set_instance(nullptr);
+      for (std::size_t i = 0; i != inputs.size(); ++i) {
+        REQUIRE(canonicalize(inputs[i]) == cached[i]);
+        REQUIRE(cached[i] == cached[0]);
+      }
+
+      cache->clear();
+      REQUIRE(cache->size() == 0);
+      REQUIRE(cache->nhits() == 0);
+
+    }  // SECTION("canonical form cache")
+
+    SECTION("trivially canonical networks") {
+      auto cache = std::make_shared<CanonicalFormCache>();
+      ScopedCanonicalFormCache scoped_cache(cache);
+
+      auto canonicalize = [](const std::wstring& input) {
+        auto factors = parse_expr(input).as<Product>().factors();
+        TensorNetworkV2 tn(factors);
+        tn.canonicalize(TensorCanonicalizer::cardinal_tensor_labels(), false);
+        return to_latex(to_product(tn.tensors()));
+      };
+
+      // equivalent inputs, the canonical graph is not needed
+      const std::vector<std::vector<std::wstring>> inputs = {
+          {L"t{a1,a2;i1,i2}:A", L"t{a2,a1;i2,i1}:A"},
+          {L"t{a1,a2;i1,i2}:S", L"t{a2,a1;i2,i1}:S"},
+          {L"f{a1;i3} t{i3;i1}", L"t{i5;i1} f{a1;i5}"},
+          {L"g{i1,a3;a1,a2}:A t{a2;i2}", L"t{a4;i2} g{i1,a3;a1,a4}:A"},
+      };
+      for (const auto& variants : inputs) {
+        const auto expected = canonicalize(variants.front());
+        for (const auto& input : variants) {
+          REQUIRE(canonicalize(input) == expected);
+        }
+        REQUIRE(canonicalize(expected) == expected);
+      }
+      REQUIRE(cache->nhits() + cache->nmisses() == 0);
+
+      // repeated labels, multiple dummies, or nonsymmetric multi-particle
+      // tensors require the canonical graph
+      for (const auto& input :
+           {L"t{a1;i2} t{a2;i1}", L"f{a3;i3} t{i3,a2;i1,a3}:A",
+            L"t{a1,a2;i1,i2}:N-C-S"}) {
+        const auto nlookups = cache->nhits() + cache->nmisses();
+        canonicalize(input);
+        REQUIRE(cache->nhits() + cache->nmisses() == nlookups + 1);
+      }
+
+    }  // SECTION("trivially canonical networks")
+
+    SECTION("batch") {
+      const TensorNetworkV2::NamedIndexSet named_indices{
+          Index{L"i_1"}, Index{L"i_2"}, Index{L"a_1"}, Index{L"a_2"}};
+      const std::vector<std::wstring> inputs = {
+          L"g{i3,i4;a3,a4}:A t{a1,a3;i1,i3}:A t{a2,a4;i2,i4}:A",
+          L"1/4 g{i3,i4;a3,a4}:A t{a3,a4;i1,i2}:A t{a1,a2;i3,i4}:A",
+          L"-1/2 g{i3,i4;a3,a4}:A t{a1,a2;i1,i3}:A t{a3,a4;i2,i4}:A",
+          L"g{a1,a2;a3,a4}:A t{a4,a3;i1,i2}:A",
+          L"f{a1;i1} t{a2;i2}",
+      };
+
+      // reference: canonicalize each network on its own
+      std::vector<std::wstring> expected;
+      for (const auto& input : inputs) {
+        auto product = parse_expr(input);
+        TensorNetworkV2 tn(product->as<Product>().factors());
+        auto bp = tn.canonicalize(TensorCanonicalizer::cardinal_tensor_labels(),
+                                  false, &named_indices);
+        auto scalar = product->as<Product>().scalar();
+        if (bp) scalar *= bp->as<Constant>().value();
+        const auto tensors = to_tensors(tn.tensors());
+        expected.push_back(to_latex(ex<Product>(scalar, tensors.begin(),
+                                                tensors.end(),
+                                                Product::Flatten::No)));
+      }
+
+      container::svector<ExprPtr> products;
+      for (const auto& input : inputs) products.push_back(parse_expr(input));
+      TensorNetworkV2::canonicalize_batch(
+          products, TensorCanonicalizer::cardinal_tensor_labels(), false,
+          named_indices);
+      REQUIRE(products.size() == inputs.size());
+      for (std::size_t i = 0; i != products.size(); ++i) {
+        REQUIRE(products[i]->is<Product>());
+        REQUIRE(to_latex(products[i]) == expected[i]);
+      }
+
+      // only products of tensors are accepted
+      container::svector<ExprPtr> not_products = {parse_expr(L"t{a1;i1}")};
+      REQUIRE_THROWS_AS(TensorNetworkV2::canonicalize_batch(
+                            not_products,
+                            TensorCanonicalizer::cardinal_tensor_labels(),
+                            false, named_indices),
+                        std::invalid_argument);
+    }  // SECTION("batch")
+
   }  // SECTION("canonicalizer")
 
   SECTION("misc1") {
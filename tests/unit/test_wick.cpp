@@ -707,6 +707,16 @@ TEST_CASE("wick", "[algorithms][wick]") {
                          .compute();
       REQUIRE(result2->is<Sum>());
       REQUIRE(result2->size() == 2);
+
+      // counting does not need to enumerate the contractions
+      auto count1 =
+          FWickTheorem{opseq}.set_external_indices(ext_indices).compute(true);
+      REQUIRE(count1->as<Constant>().value<int>() == 9);
+      auto count2 = FWickTheorem{opseq}
+                        .set_external_indices(ext_indices)
+                        .set_nop_connections({{1, 2}, {1, 3}})
+                        .compute(true);
+      REQUIRE(count2->as<Constant>().value<int>() == 2);
     }
 
     // 4-body ^ 2-body ^ 2-body
@@ -732,6 +742,70 @@ TEST_CASE("wick", "[algorithms][wick]") {
       auto result = wick.compute();
       REQUIRE(result->is<Sum>());
       REQUIRE(result->size() == 80);
+
+      // stats
+      const auto& stats = wick.stats();
+      REQUIRE(stats.num_terms == 80);
+      REQUIRE(stats.num_visited_nodes > 0);
+      REQUIRE(stats.num_useful_contractions <=
+              stats.num_attempted_contractions);
+      REQUIRE(stats.elapsed(FWickTheorem::Stats::Phase::recursion) > 0);
+      const auto json = stats.to_json();
+      REQUIRE(json.find("\"num_terms\": 80") != std::string::npos);
+      REQUIRE(json.find("\"recursion\": ") != std::string::npos);
+    }
+
+    // the top of the contraction tree is explored by tasks if using multiple
+    // threads, the results and the stats must not depend on it
+    {
+      auto opseq = ex<FNOperatorSeq>(
+          FNOperator(cre({L"p_1", L"p_2"}), ann({L"p_5", L"p_6"})),
+          FNOperator(cre({L"p_9", L"p_10"}), ann({L"p_11", L"p_12"})),
+          FNOperator(cre({L"p_17", L"p_18"}), ann({L"p_19", L"p_20"})));
+      struct NumThreadsResetter {
+        int nthreads = num_threads();
+        ~NumThreadsResetter() { set_num_threads(nthreads); }
+      } num_threads_resetter;
+      auto compute = [&opseq](int nthreads, bool full_contractions) {
+        set_num_threads(nthreads);
+        auto wick = FWickTheorem{opseq};
+        auto result = wick.full_contractions(full_contractions).compute();
+        std::vector<std::wstring> terms;
+        for (auto&& term : *result) terms.emplace_back(to_latex(term));
+        ranges::sort(terms);
+        return std::make_pair(terms, wick.stats());
+      };
+      for (const bool full_contractions : {true, false}) {
+        const auto [serial_terms, serial_stats] = compute(1, full_contractions);
+        const auto [terms, stats] = compute(4, full_contractions);
+        CHECK(terms == serial_terms);
+        CHECK(stats.num_terms == serial_stats.num_terms);
+        CHECK(stats.num_visited_nodes == serial_stats.num_visited_nodes);
+        CHECK(stats.num_pruned_branches == serial_stats.num_pruned_branches);
+        CHECK(stats.num_attempted_contractions ==
+              serial_stats.num_attempted_contractions);
+        CHECK(stats.num_useful_contractions ==
+              serial_stats.num_useful_contractions);
+      }
+    }
+
+    // the state of the recursion is sized for the input: exercise each size
+    // with a chain of 1-body ops in which each qp-annihilator can only be
+    // fully contracted with the qp-creator that follows it
+    for (const std::size_t nnops : {8, 16, 32}) {
+      FNOperatorSeq opseq;
+      for (std::size_t i = 0; i != nnops; i += 2) {
+        opseq.push_back(
+            FNOperator(cre({}), ann({L"a_" + std::to_wstring(i + 1)})));
+        opseq.push_back(
+            FNOperator(cre({L"a_" + std::to_wstring(i + 2)}), ann({})));
+      }
+      auto wick = FWickTheorem{opseq};
+      auto result = wick.compute();
+      REQUIRE(result->is<Product>());
+      REQUIRE(result->as<Product>().scalar() == 1);
+      REQUIRE(result->as<Product>().size() == nnops / 2);
+      REQUIRE(wick.stats().num_terms == 1);
     }
 
     // 2-body ^ 2-body ^ 2-body ^ 2-body
@@ -1137,5 +1211,112 @@ TEST_CASE("wick", "[algorithms][wick]") {
     });
 #endif
   }
+
+  SECTION("memoization") {
+    auto cache = std::make_shared<WickCache>();
+    WickCache::set_instance(cache);
+    struct WickCacheResetter {
+      ~WickCacheResetter() { WickCache::set_instance(nullptr); }
+    } wick_cache_resetter;
+
+    auto make_input = [](rational scalar, std::wstring i1, std::wstring i2) {
+      return ex<Constant>(scalar) *
+             ex<Tensor>(L"g", bra{L"i_1", L"i_2"}, ket{L"a_1", L"a_2"},
+                        Symmetry::antisymm) *
+             ex<FNOperator>(cre{L"i_1", L"i_2"}, ann{L"a_1", L"a_2"}) *
+             ex<Tensor>(L"t", bra{L"a_3", L"a_4"}, ket{i1, i2},
+                        Symmetry::antisymm) *
+             ex<FNOperator>(cre{L"a_3", L"a_4"}, ann{i1, i2});
+    };
+
+    auto result1 = FWickTheorem{make_input(1, L"i_3", L"i_4")}.compute();
+    REQUIRE(cache->size() == 1);
+    REQUIRE(cache->nhits() == 0);
+
+    // same topology, different dummy labels and scalar => cache hit
+    FWickTheorem wick2{make_input(2, L"i_5", L"i_6")};
+    auto result2 = wick2.compute();
+    REQUIRE(cache->size() == 1);
+    REQUIRE(cache->nhits() == 1);
+    REQUIRE(wick2.stats().num_cache_hits == 1);
+
+    // if told to skip canonicalization the input is not canonicalized to
+    // compute the key, hence different dummy labels => cache miss
+    auto result3 = FWickTheorem{make_input(3, L"i_7", L"i_8")}.compute(
+        false, /* skip_input_canonicalization = */ true);
+    REQUIRE(cache->size() == 2);
+    REQUIRE(cache->nhits() == 1);
+    REQUIRE(simplify(canonicalize(result3) -
+                     ex<Constant>(3) * canonicalize(result1->clone())) ==
+            ex<Constant>(0));
+
+    // must get the same result as without the cache
+    WickCache::set_instance(nullptr);
+    auto result2_ref = FWickTheorem{make_input(2, L"i_5", L"i_6")}.compute();
+    canonicalize(result2);
+    canonicalize(result2_ref);
+    REQUIRE(simplify(result2 - result2_ref) == ex<Constant>(0));
+    REQUIRE(simplify(result2 - ex<Constant>(2) * result1) == ex<Constant>(0));
+
+    // the external indices keep their labels, the dummy indices of the cached
+    // result are relabeled onto those of the input
+    WickCache::set_instance(cache);
+    auto make_open_input = [](std::wstring i1, std::wstring i2,
+                              std::wstring a1, std::wstring a2) {
+      return ex<Tensor>(L"g", bra{i1, i2}, ket{a1, a2}, Symmetry::antisymm) *
+             ex<FNOperator>(cre{i1, i2}, ann{a1, a2}) *
+             ex<FNOperator>(cre{L"a_3", L"a_4"}, ann{L"i_3", L"i_4"});
+    };
+    FWickTheorem{make_open_input(L"i_1", L"i_2", L"a_1", L"a_2")}.compute();
+    REQUIRE(cache->size() == 3);
+    auto open2 =
+        FWickTheorem{make_open_input(L"i_5", L"i_6", L"a_5", L"a_6")}.compute();
+    REQUIRE(cache->size() == 3);
+    REQUIRE(cache->nhits() == 2);
+    FWickTheorem wick_topology{
+        make_open_input(L"i_5", L"i_6", L"a_5", L"a_6")};
+    wick_topology.use_topology(true).compute();
+    REQUIRE(cache->size() == 4);
+    REQUIRE(cache->nhits() == 2);
+
+    WickCache::set_instance(nullptr);
+    auto open2_ref =
+        FWickTheorem{make_open_input(L"i_5", L"i_6", L"a_5", L"a_6")}.compute();
+    canonicalize(open2);
+    canonicalize(open2_ref);
+    REQUIRE(simplify(open2 - open2_ref) == ex<Constant>(0));
+  }
+
+  SECTION("sink") {
+    auto input = ex<Constant>(rational{1, 16}) *
+                 ex<Tensor>(L"g", bra{L"i_1", L"i_2"}, ket{L"a_1", L"a_2"},
+                            Symmetry::antisymm) *
+                 ex<FNOperator>(cre{L"i_1", L"i_2"}, ann{L"a_1", L"a_2"}) *
+                 ex<Tensor>(L"g", bra{L"p_1", L"p_2"}, ket{L"p_3", L"p_4"},
+                            Symmetry::antisymm) *
+                 ex<FNOperator>(cre{L"p_1", L"p_2"}, ann{L"p_3", L"p_4"}) *
+                 ex<Tensor>(L"t", bra{L"a_3", L"a_4"}, ket{L"i_3", L"i_4"},
+                            Symmetry::antisymm) *
+                 ex<FNOperator>(cre{L"a_3", L"a_4"}, ann{L"i_3", L"i_4"});
+    auto result_ref = FWickTheorem{input->clone()}.compute();
+
+    // the sink can be called by the worker threads (one at a time), hence
+    // only collect the terms in it and check them on this thread
+    std::vector<ExprPtr> terms;
+    auto sink_result =
+        FWickTheorem{input}
+            .set_sink([&terms](ExprPtr term) {
+              terms.emplace_back(std::move(term));
+            })
+            .compute();
+    REQUIRE(sink_result == ex<Constant>(0));
+    REQUIRE(terms.size() > 1);
+    auto result = ex<Sum>();
+    for (auto&& term : terms) {
+      REQUIRE(term->is<Product>());
+      result->as<Sum>().append(term);
+    }
+    REQUIRE(simplify(result - result_ref) == ex<Constant>(0));
+  }
 }
 #endif